@@ -63,6 +63,20 @@ TU_ERROR TUcreateEnvironment(
   TU** ptu /**< Pointer at which the \ref TU environment shall be allocated. */
 );
 
+/**
+ * \brief Creates a \ref TU environment for use by another thread.
+ *
+ * The new environment has its own stack memory, so it can be used concurrently with \p tu. Stack memory that is no
+ * longer needed is shared via a pool with \p tu and all environments created from it. Its output and verbosity are
+ * copied from \p tu. It must be freed by \ref TUfreeEnvironment before \p tu is freed.
+ */
+
+TU_EXPORT
+TU_ERROR TUcreateThreadEnvironment(
+  TU* tu,     /**< \ref TU environment. */
+  TU** pchild /**< Pointer at which the new environment shall be allocated. */
+);
+
 /**
  * \brief Frees a \ref TU environment.
  */
@@ -72,6 +86,28 @@ TU_ERROR TUfreeEnvironment(
   TU** ptu /**< Pointer to \ref TU environment. */
 );
 
+/**
+ * \brief Sets the number of threads used by \p tu.
+ *
+ * Independent parts of a computation, e.g., the 1-connected components of a matrix, are processed by this many
+ * threads. The default is 1. Has no effect if the library was built without support for threads.
+ */
+
+TU_EXPORT
+TU_ERROR TUsetNumThreads(
+  TU* tu,         /**< \ref TU environment. */
+  int numThreads  /**< Number of threads; must be positive. */
+);
+
+/**
+ * \brief Returns the number of threads used by \p tu.
+ */
+
+TU_EXPORT
+int TUgetNumThreads(
+  TU* tu  /**< \ref TU environment. */
+);
+
 /**
  * \brief Allocates block memory for *\p ptr.
  *
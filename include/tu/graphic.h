@@ -103,6 +103,9 @@ TU_ERROR TUcomputeGraphTernaryRepresentationMatrix(
  * If \f$ M \f$ is not such a representation matrix and \p psubmatrix != \c NULL, then a minimal submatrix of
  * \f$ M \f$ with the same property is computed and stored in *\p psubmatrix.
  * The caller must release the memory via \ref TUsubmatFree.
+ *
+ * If it is called by a concurrent task of the library that gets cancelled, then the test stops with
+ * *\p pisGraphic = \c false.
  */
 
 TU_EXPORT
@@ -153,6 +156,94 @@ TU_ERROR TUtestTernaryGraphic(
   TU_SUBMAT** psubmatrix          /**< Pointer for storing a minimal nongraphic submatrix (if nongraphic). */
 );
 
+/**
+ * \brief Decomposition of a graphic binary matrix to which columns can be added incrementally.
+ *
+ * The structure maintains a graph \f$ G \f$ and spanning forest \f$ T \f$ such that the columns added so far form the
+ * binary representation matrix \f$ M(G,T) \f$. Checking whether another column maintains graphicness and adding
+ * it takes almost linear time in the number of its nonzeros, amortized over all added columns.
+ */
+
+typedef struct _TU_GRAPHIC_DEC TU_GRAPHIC_DEC;
+
+/**
+ * \brief Creates a graphic decomposition with \p numRows rows and no columns.
+ *
+ * The caller must release the memory via \ref TUgraphicDecFree.
+ */
+
+TU_EXPORT
+TU_ERROR TUgraphicDecCreate(
+  TU* tu,                 /**< \ref TU environment. */
+  TU_GRAPHIC_DEC** pgdec, /**< Pointer for storing the decomposition. */
+  int numRows             /**< Number of rows of the represented matrix. */
+);
+
+/**
+ * \brief Frees a graphic decomposition.
+ */
+
+TU_EXPORT
+TU_ERROR TUgraphicDecFree(
+  TU* tu,                 /**< \ref TU environment. */
+  TU_GRAPHIC_DEC** pgdec  /**< Pointer to decomposition. */
+);
+
+/**
+ * \brief Returns the number of rows of the matrix represented by \p gdec.
+ */
+
+TU_EXPORT
+int TUgraphicDecNumRows(
+  TU_GRAPHIC_DEC* gdec  /**< Graphic decomposition. */
+);
+
+/**
+ * \brief Returns the number of columns added to \p gdec so far.
+ */
+
+TU_EXPORT
+int TUgraphicDecNumColumns(
+  TU_GRAPHIC_DEC* gdec  /**< Graphic decomposition. */
+);
+
+/**
+ * \brief Checks whether appending a binary column to the matrix represented by \p gdec maintains graphicness.
+ *
+ * The column has its 1-entries in the distinct rows \p rows. The result is stored in *\p pisGraphic. If \p apply is
+ * \c true and the column maintains graphicness, then it is added to \p gdec as column
+ * \ref TUgraphicDecNumColumns(gdec). Otherwise, \p gdec remains unchanged.
+ */
+
+TU_EXPORT
+TU_ERROR TUgraphicDecAddColumn(
+  TU* tu,               /**< \ref TU environment. */
+  TU_GRAPHIC_DEC* gdec, /**< Graphic decomposition. */
+  int* rows,            /**< Array with the rows having a 1-entry in the new column. */
+  int numRows,          /**< Length of \p rows. */
+  bool apply,           /**< Whether to add the column if it maintains graphicness. */
+  bool* pisGraphic      /**< Pointer for storing whether the column maintains graphicness. */
+);
+
+/**
+ * \brief Computes a graph represented by the columns added to \p gdec so far.
+ *
+ * Computes \f$ G \f$ such that \f$ M(G,T) \f$ is the matrix with \ref TUgraphicDecNumRows(gdec) rows and the added
+ * columns. If *\p pgraph is \c NULL, a new graph is created and the caller must release the memory via
+ * \ref TUgraphFree. If \p pforestEdges (resp. \p pcoforestEdges) != \c NULL, then the edges of \f$ T \f$
+ * (resp.\ of \f$ E \setminus T \f$) are stored in *\p pforestEdges (resp. *\p pcoforestEdges), which are allocated
+ * if \c NULL. The caller must then release the memory via \ref TUfreeBlockArray.
+ */
+
+TU_EXPORT
+TU_ERROR TUgraphicDecGraph(
+  TU* tu,                         /**< \ref TU environment. */
+  TU_GRAPHIC_DEC* gdec,           /**< Graphic decomposition. */
+  TU_GRAPH** pgraph,              /**< Pointer for storing \ref Graph \f$ G \f$. */
+  TU_GRAPH_EDGE** pforestEdges,   /**< Pointer for storing \f$ T \f$ (may be \c NULL). */
+  TU_GRAPH_EDGE** pcoforestEdges  /**< Pointer for storing \f$ E \setminus T \f$ (may be \c NULL). */
+);
+
 /**
  * \brief Finds an inclusion-wise maximal subset of columns that induce a graphic binary submatrix.
  *
@@ -693,7 +693,7 @@ namespace tu
         /// Major index.
         Index _major;
         /// Index of the entry relative to this major.
-        Value _index;
+        Index _index;
     };
 
     typedef detail::Range<NonzeroIterator<true>> NonzeroRowRange;
@@ -1,9 +1,12 @@
 #pragma once
 
+#include <vector>
+
 #include <tu/config.h>
 #include <tu/export.h>
 
 #include "common.hpp"
+#include "matrix.hpp"
 
 namespace tu
 {
@@ -11,6 +14,16 @@ namespace tu
 
   class decomposed_matroid;
 
+  /**
+   * Sets the number of threads, including the calling one, that the tests called from the calling thread may use.
+   * By default, they run sequentially. It must not be changed while such a test runs.
+   *
+   * @param num_threads Number of threads; values below 1 are treated as 1
+   */
+
+  TU_EXPORT
+  void set_num_threads(size_t num_threads);
+
   /**
    * Returns a decomposition of a given binary matroid into a k-sum-decomposition (k=1,2,3)
    * in graphic, cographic, R10 and maybe irregular components.
@@ -90,6 +103,32 @@ namespace tu
   bool is_totally_unimodular(const integer_matrix& matrix, decomposed_matroid*& decomposition, submatrix_indices& violator, log_level level =
       LOG_QUIET);
 
+  /**
+   * Tests a sparse matrix for total unimodularity without certificates.
+   * The matrix stays sparse for the -1,0,+1 test, the 1-sum decomposition,
+   * the signing test and the graphicness tests. Only components which are
+   * neither graphic nor cographic are decomposed in a dense binary form.
+   *
+   * @param matrix The matrix to be tested
+   * @return true if and only if the matrix is totally unimodular
+   */
+
+  TU_EXPORT
+  bool is_totally_unimodular(const SparseMatrix <char>& matrix);
+
+  /**
+   * Tests a sparse matrix for total unimodularity with a negative certificate.
+   * If the matrix does not have this property, the routine returns the indices
+   * of a violating submatrix.
+   *
+   * @param matrix The matrix to be tested
+   * @param violator Returns violator indices
+   * @return true if and only if the matrix is totally unimodular
+   */
+
+  TU_EXPORT
+  bool is_totally_unimodular(const SparseMatrix <char>& matrix, submatrix_indices& violator);
+
   /**
    * Tests if the given matrix contains only -1,0,+1 entries.
    *
@@ -184,10 +223,24 @@ namespace tu
    * @param matrix A given integer matrix
    * @param submatrix Matrix-indices describing a submatrix
    * @return The submatrix' determinant
+   * @throws std::overflow_error if the determinant does not fit into a long long
+   */
+
+  TU_EXPORT
+  long long submatrix_determinant(const integer_matrix& matrix, const submatrix_indices& submatrix);
+
+  /**
+   * Calculates several subdeterminants of the given matrix, reusing the scratch memory.
+   *
+   * @param matrix A given integer matrix
+   * @param submatrices Matrix-indices describing the submatrices
+   * @param determinants Returns the submatrices' determinants in the same order
+   * @throws std::overflow_error if a determinant does not fit into a long long
    */
 
   TU_EXPORT
-  int submatrix_determinant(const integer_matrix& matrix, const submatrix_indices& submatrix);
+  void submatrix_determinants(const integer_matrix& matrix, const std::vector <submatrix_indices>& submatrices,
+      std::vector <long long>& determinants);
 
   /**
    * Checks all subdeterminants to test a given matrix for total unimodularity.
@@ -167,7 +167,7 @@ bool test_total_unimodularity(tu::integer_matrix& matrix, bool show_certificates
     }
     else
     {
-      int det = tu::submatrix_determinant(matrix, violator);
+      long long det = tu::submatrix_determinant(matrix, violator);
       assert (violator.rows.size() == violator.columns.size());
       std::cout << "\nThe matrix is not totally unimodular due to the following " << violator.rows.size() << " x " << violator.columns.size()
           << " submatrix with determinant " << det << "." << std::endl;
@@ -9,6 +9,10 @@
 #include "r10.hpp"
 #include "enumeration.hpp"
 #include "logger.hpp"
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <atomic>
 
 namespace tu
 {
@@ -16,137 +20,198 @@ namespace tu
 
   template <typename MatroidType, typename MatrixType>
   std::pair<bool, decomposed_matroid*> decompose_binary_matroid(MatroidType& matroid, MatrixType& matrix,
-      matroid_element_set extra_elements, bool construct_decomposition, logger& log);
+      matroid_element_set extra_elements, bool construct_decomposition, logger& log,
+      std::atomic <bool>* cancelled = NULL);
 
   template <typename MatroidType, typename MatrixType>
   std::pair<bool, decomposed_matroid*> decompose_with_minor_sequence(matroid_permuted<MatroidType>& permuted_matroid,
       matrix_permuted<MatrixType>& permuted_matrix, nested_minor_sequence& nested_minors,
-      matroid_element_set extra_elements, bool construct_decomposition, logger& log)
+      matroid_element_set extra_elements, bool construct_decomposition, logger& log, std::atomic <bool>* cancelled);
+
+  namespace detail
   {
-    separation sep = find_minor_sequence(permuted_matroid, permuted_matrix, nested_minors, extra_elements, log);
-    if (sep.is_valid())
+
+    /**
+     * Results of the graphicness, cographicness and R10 tests of a matroid. Each of them may decide regularity on its
+     * own, so the first conclusive one cancels the others.
+     */
+
+    struct leaf_test_state
     {
-      if (log.is_progressive())
-      {
-        log.line() << " --> " << (sep.rank() + 1) << "-SEP";
-        std::cout << log << std::endl;
-        log.clear();
-        log.indent();
-      }
-      else if (log.is_verbose())
+      leaf_test_state() :
+        cancelled(false), is_r10(false), is_graphic(false), is_cographic(false), graph(NULL), cograph(NULL)
       {
-        std::cout << "Found a " << (sep.rank() + 1) << "-separation instead." << std::endl;
+
       }
 
-      integer_matroid upper_left_matroid;
-      integer_matrix upper_left_matrix;
-      integer_matroid lower_right_matroid;
-      integer_matrix lower_right_matrix;
+      std::atomic <bool> cancelled;
+      bool is_r10;
+      bool is_graphic;
+      bool is_cographic;
+      matroid_graph* graph;
+      matroid_graph* cograph;
+    };
 
-      sep.create_components(permuted_matroid, permuted_matrix, upper_left_matroid, upper_left_matrix,
-          lower_right_matroid, lower_right_matrix);
+    /**
+     * Runs the R10 test (task 0), the graphicness test (task 1) or the cographicness test (task 2). R10 is neither
+     * graphic nor cographic, and if no decomposition is requested, then a graphic or cographic matroid is regular
+     * regardless of the other test. The cheap R10 test comes first such that it also cancels the others if there are
+     * no threads.
+     */
 
-      if (log.is_verbose())
+    template <typename MatroidType, typename MatrixType>
+    struct leaf_test_worker
+    {
+      matroid_permuted <MatroidType>& matroid;
+      matrix_permuted <MatrixType>& matrix;
+      bool construct_decomposition;
+      leaf_test_state& state;
+
+      void operator()(size_t task) const
       {
-        std::cout << "Summands are " << upper_left_matrix.size1() << " x " << upper_left_matrix.size2() << " and "
-            << lower_right_matrix.size1() << " x " << lower_right_matrix.size2() << "." << std::endl;
+        if (task == 0)
+        {
+          state.is_r10 = is_r10(matrix);
+          if (state.is_r10)
+            state.cancelled = true;
+        }
+        else if (task == 1)
+        {
+          state.graph = construct_matroid_graph(matroid, matrix, construct_decomposition, state.is_graphic,
+              &state.cancelled);
+          if (state.is_graphic && !construct_decomposition)
+            state.cancelled = true;
+        }
+        else
+        {
+          state.cograph = construct_matroid_graph(make_transposed_matroid(matroid), make_transposed_matrix(matrix),
+              construct_decomposition, state.is_cographic, &state.cancelled);
+          if (state.is_cographic && !construct_decomposition)
+            state.cancelled = true;
+        }
       }
+    };
 
-      /// Filter or copy extra_elements depending on type of separation
-      matroid_element_set upper_left_extra_elements, lower_right_extra_elements;
-      if (sep.rank() == 0)
-      {
-        matroid_element_set upper_left_elements = upper_left_matroid.get_elements();
-        matroid_element_set lower_right_elements = lower_right_matroid.get_elements();
+    /**
+     * Decomposes the upper-left summand of a separation, continuing with the given sequence of nested minors if it is
+     * not NULL.
+     */
 
-        std::set_difference(extra_elements.begin(), extra_elements.end(), lower_right_elements.begin(),
-            lower_right_elements.end(), std::inserter(upper_left_extra_elements, upper_left_extra_elements.end()));
-        std::set_difference(extra_elements.begin(), extra_elements.end(), upper_left_elements.begin(),
-            upper_left_elements.end(), std::inserter(lower_right_extra_elements, lower_right_extra_elements.end()));
-      }
+    template <typename MatroidType, typename MatrixType>
+    inline std::pair<bool, decomposed_matroid*> decompose_summand(matroid_permuted <MatroidType>& matroid,
+        matrix_permuted <MatrixType>& matrix, nested_minor_sequence* nested_minors,
+        const matroid_element_set& extra_elements, bool construct_decomposition, logger& log,
+        std::atomic <bool>* cancelled)
+    {
+      if (nested_minors)
+        return decompose_with_minor_sequence(matroid, matrix, *nested_minors, extra_elements, construct_decomposition,
+            log, cancelled);
       else
-      {
-        std::copy(extra_elements.begin(), extra_elements.end(), std::inserter(upper_left_extra_elements,
-            upper_left_extra_elements.end()));
-        std::copy(extra_elements.begin(), extra_elements.end(), std::inserter(lower_right_extra_elements,
-            lower_right_extra_elements.end()));
-      }
+        return decompose_binary_matroid(matroid, matrix, extra_elements, construct_decomposition, log, cancelled);
+    }
 
-      matroid_permuted<integer_matroid> permuted_upper_left_matroid(upper_left_matroid);
-      matrix_permuted<integer_matrix> permuted_upper_left_matrix(upper_left_matrix);
+    template <typename MatroidType, typename MatrixType>
+    inline std::pair<bool, decomposed_matroid*> decompose_summand(MatroidType& matroid, MatrixType& matrix,
+        nested_minor_sequence* nested_minors, const matroid_element_set& extra_elements, bool construct_decomposition,
+        logger& log, std::atomic <bool>* cancelled)
+    {
+      assert(nested_minors == NULL);
+      return decompose_binary_matroid(matroid, matrix, extra_elements, construct_decomposition, log, cancelled);
+    }
 
-      if (sep.has_special_swap())
-      {
-        if (sep.has_special_row_swap())
-          matroid_permute1(permuted_upper_left_matroid, permuted_upper_left_matrix, upper_left_matroid.size1() - 1,
-              sep.get_special_swap_index());
+    /**
+     * Decomposes the upper-left summand of a separation (task 0) or the lower-right one (task 1) and stores the
+     * result in results[task]. If no decomposition is constructed, then cancelled is shared by the whole recursion
+     * tree and set as soon as some part is not regular, since then the whole matroid is not regular.
+     */
+
+    template <typename UpperLeftMatroidType, typename UpperLeftMatrixType, typename LowerRightMatroidType,
+        typename LowerRightMatrixType>
+    struct summand_decomposition
+    {
+      UpperLeftMatroidType& upper_left_matroid;
+      UpperLeftMatrixType& upper_left_matrix;
+      matroid_element_set& upper_left_extra_elements;
+      nested_minor_sequence* nested_minors;
+      LowerRightMatroidType& lower_right_matroid;
+      LowerRightMatrixType& lower_right_matrix;
+      matroid_element_set& lower_right_extra_elements;
+      bool construct_decomposition;
+      logger& log;
+      std::atomic <bool>* cancelled;
+      std::pair <bool, decomposed_matroid*>* results;
+
+      void operator()(size_t task) const
+      {
+        if (task == 0)
+        {
+          results[0] = decompose_summand(upper_left_matroid, upper_left_matrix, nested_minors,
+              upper_left_extra_elements, construct_decomposition, log, cancelled);
+        }
         else
-          matroid_permute2(permuted_upper_left_matroid, permuted_upper_left_matrix, upper_left_matroid.size2() - 1,
-              sep.get_special_swap_index());
-      }
+        {
+          results[1] = decompose_binary_matroid(lower_right_matroid, lower_right_matrix, lower_right_extra_elements,
+              construct_decomposition, log, cancelled);
+        }
 
-      if (log.is_progressive())
-      {
-        log.line() << "(" << upper_left_matrix.size1() << " x " << upper_left_matrix.size2() << ") W3";
-        std::cout << log;
-      }
-      else if (log.is_verbose())
-      {
-        std::cout << "Proceeding search for a sequence of nested minors in binary "
-            << permuted_upper_left_matroid.size1() << " x " << permuted_upper_left_matrix.size2() << " matroid."
-            << std::endl;
+        if (cancelled && !results[task].first)
+          *cancelled = true;
       }
+    };
 
-      std::pair<bool, decomposed_matroid*> upper_left_result = decompose_with_minor_sequence(
-          permuted_upper_left_matroid, permuted_upper_left_matrix, nested_minors, upper_left_extra_elements,
-          construct_decomposition, log);
-
-      if (!construct_decomposition && !upper_left_result.first)
-      {
-        log.unindent();
-        return std::pair<bool, decomposed_matroid*>(false, NULL);
-      }
+    /**
+     * Decomposes both summands of a separation. They are processed concurrently if threads are idle, unless output
+     * is logged. The results do not depend on the order of processing.
+     */
 
-      std::pair<bool, decomposed_matroid*> lower_right_result = decompose_binary_matroid(lower_right_matroid,
-          lower_right_matrix, lower_right_extra_elements, construct_decomposition, log);
+    template <typename UpperLeftMatroidType, typename UpperLeftMatrixType, typename LowerRightMatroidType,
+        typename LowerRightMatrixType>
+    inline void decompose_summands(summand_decomposition <UpperLeftMatroidType, UpperLeftMatrixType,
+        LowerRightMatroidType, LowerRightMatrixType>& summands)
+    {
+      std::atomic <bool> cancelled(false);
+      if (!summands.construct_decomposition && !summands.cancelled)
+        summands.cancelled = &cancelled;
 
-      if (log.is_progressive())
+      if (summands.log.is_quiet())
+        run_tasks(2, summands);
+      else
       {
-        log.unindent();
+        summands(0);
+        summands(1);
       }
+    }
 
-      if (construct_decomposition)
-      {
-        int type = sep.rank() == 0 ? static_cast<int>(decomposed_matroid_separator::ONE_SEPARATION)
-            : static_cast<int>(decomposed_matroid_separator::TWO_SEPARATION);
+  } /* namespace detail */
 
-        return std::pair<bool, decomposed_matroid*>(lower_right_result.first && upper_left_result.first,
-            new decomposed_matroid_separator(upper_left_result.second, lower_right_result.second, type,
-                matroid_elements(permuted_matroid), extra_elements));
-      }
-      else
-        return std::pair<bool, decomposed_matroid*>(lower_right_result.first, NULL);
-    }
+  template <typename MatroidType, typename MatrixType>
+  std::pair<bool, decomposed_matroid*> decompose_with_minor_sequence(matroid_permuted<MatroidType>& permuted_matroid,
+      matrix_permuted<MatrixType>& permuted_matrix, nested_minor_sequence& nested_minors,
+      matroid_element_set extra_elements, bool construct_decomposition, logger& log, std::atomic <bool>* cancelled)
+  {
+    typedef matroid_summand <typename detail::summand_traits <MatroidType>::root_type> summand_matroid_type;
+    typedef matrix_summand <typename detail::summand_traits <MatrixType>::root_type> summand_matrix_type;
 
-    if (log.is_verbose())
-    {
-      std::cout << "Constructed sequence of " << (nested_minors.size() + 1)
-          << " 3-connected nested minors starting with W3." << std::endl;
-    }
+    if (cancelled && *cancelled)
+      return std::pair<bool, decomposed_matroid*>(false, NULL);
 
-    size_t largest_graphic_minor = 0;
-    matroid_graph* graph = construct_matroid_graph(permuted_matroid, permuted_matrix, nested_minors,
-        largest_graphic_minor);
+    /// The leaf tests do not need the sequence of nested minors, which is only constructed if all of them fail.
+    detail::leaf_test_state tests;
+    detail::leaf_test_worker <MatroidType, MatrixType> worker = { permuted_matroid, permuted_matrix,
+        construct_decomposition, tests };
+    detail::run_tasks(3, worker);
+    matroid_graph* graph = tests.graph;
+    matroid_graph* cograph = tests.cograph;
 
     if (log.is_progressive())
     {
-      log.line() << (graph == NULL ? ", NON-GRAPHIC" : ", GRAPHIC");
+      log.line() << (!tests.is_graphic ? ", NON-GRAPHIC" : ", GRAPHIC");
       std::cout << log;
     }
     else if (log.is_verbose())
-      std::cout << "Matroid is " << (graph == NULL ? "not " : "") << "graphic." << std::endl;
+      std::cout << "Matroid is " << (!tests.is_graphic ? "not " : "") << "graphic." << std::endl;
 
-    if (!construct_decomposition && graph)
+    if (!construct_decomposition && tests.is_graphic)
     {
       if (log.is_progressive())
       {
@@ -158,25 +223,20 @@ namespace tu
         std::cout << "Graphic matroids are always regular." << std::endl;
       }
 
-      delete graph;
       return std::make_pair(true, (decomposed_matroid*) NULL);
     }
 
-    size_t largest_cographic_minor = 0;
-    matroid_graph* cograph = construct_matroid_graph(make_transposed_matroid(permuted_matroid), make_transposed_matrix(
-        permuted_matrix), make_transposed_nested_minor_sequence(nested_minors), largest_cographic_minor);
-
     if (log.is_progressive())
     {
-      log.line() << (cograph == NULL ? ", NON-COGRAPHIC" : ", COGRAPHIC");
+      log.line() << (!tests.is_cographic ? ", NON-COGRAPHIC" : ", COGRAPHIC");
       std::cout << log;
     }
     else if (log.is_verbose())
     {
-      std::cout << "Matroid is " << (cograph == NULL ? "not " : "") << "cographic." << std::endl;
+      std::cout << "Matroid is " << (!tests.is_cographic ? "not " : "") << "cographic." << std::endl;
     }
 
-    if (!construct_decomposition && cograph)
+    if (!construct_decomposition && tests.is_cographic)
     {
       if (log.is_progressive())
       {
@@ -188,7 +248,6 @@ namespace tu
         std::cout << "Cographic matroids are always regular." << std::endl;
       }
 
-      delete cograph;
       return std::make_pair(true, (decomposed_matroid*) NULL);
     }
 
@@ -214,7 +273,7 @@ namespace tu
           matroid_elements(permuted_matroid), extra_elements));
     }
 
-    if (is_r10(permuted_matrix))
+    if (tests.is_r10)
     {
       if (log.is_progressive())
       {
@@ -246,7 +305,120 @@ namespace tu
         std::cout << "Matroid is not isomorphic to R10." << std::endl;
     }
 
-    size_t new_size = largest_graphic_minor > largest_cographic_minor ? largest_graphic_minor : largest_cographic_minor;
+    detail::nested_minor_graphicness graphicness;
+    separation sep = find_minor_sequence(permuted_matroid, permuted_matrix, nested_minors, extra_elements, graphicness,
+        log);
+    if (sep.is_valid())
+    {
+      if (log.is_progressive())
+      {
+        log.line() << " --> " << (sep.rank() + 1) << "-SEP";
+        std::cout << log << std::endl;
+        log.clear();
+        log.indent();
+      }
+      else if (log.is_verbose())
+      {
+        std::cout << "Found a " << (sep.rank() + 1) << "-separation instead." << std::endl;
+      }
+
+      summand_matroid_type upper_left_matroid;
+      summand_matrix_type upper_left_matrix;
+      summand_matroid_type lower_right_matroid;
+      summand_matrix_type lower_right_matrix;
+
+      sep.create_components(permuted_matroid, permuted_matrix, upper_left_matroid, upper_left_matrix,
+          lower_right_matroid, lower_right_matrix);
+
+      if (log.is_verbose())
+      {
+        std::cout << "Summands are " << upper_left_matrix.size1() << " x " << upper_left_matrix.size2() << " and "
+            << lower_right_matrix.size1() << " x " << lower_right_matrix.size2() << "." << std::endl;
+      }
+
+      /// Filter or copy extra_elements depending on type of separation
+      matroid_element_set upper_left_extra_elements, lower_right_extra_elements;
+      if (sep.rank() == 0)
+      {
+        matroid_element_set upper_left_elements = matroid_elements(upper_left_matroid);
+        matroid_element_set lower_right_elements = matroid_elements(lower_right_matroid);
+
+        std::set_difference(extra_elements.begin(), extra_elements.end(), lower_right_elements.begin(),
+            lower_right_elements.end(), std::inserter(upper_left_extra_elements, upper_left_extra_elements.end()));
+        std::set_difference(extra_elements.begin(), extra_elements.end(), upper_left_elements.begin(),
+            upper_left_elements.end(), std::inserter(lower_right_extra_elements, lower_right_extra_elements.end()));
+      }
+      else
+      {
+        std::copy(extra_elements.begin(), extra_elements.end(), std::inserter(upper_left_extra_elements,
+            upper_left_extra_elements.end()));
+        std::copy(extra_elements.begin(), extra_elements.end(), std::inserter(lower_right_extra_elements,
+            lower_right_extra_elements.end()));
+      }
+
+      matroid_permuted <summand_matroid_type> permuted_upper_left_matroid(upper_left_matroid);
+      matrix_permuted <summand_matrix_type> permuted_upper_left_matrix(upper_left_matrix);
+
+      if (sep.has_special_swap())
+      {
+        if (sep.has_special_row_swap())
+          matroid_permute1(permuted_upper_left_matroid, permuted_upper_left_matrix, upper_left_matroid.size1() - 1,
+              sep.get_special_swap_index());
+        else
+          matroid_permute2(permuted_upper_left_matroid, permuted_upper_left_matrix, upper_left_matroid.size2() - 1,
+              sep.get_special_swap_index());
+      }
+
+      if (log.is_progressive())
+      {
+        log.line() << "(" << upper_left_matrix.size1() << " x " << upper_left_matrix.size2() << ") W3";
+        std::cout << log;
+      }
+      else if (log.is_verbose())
+      {
+        std::cout << "Proceeding search for a sequence of nested minors in binary "
+            << permuted_upper_left_matroid.size1() << " x " << permuted_upper_left_matrix.size2() << " matroid."
+            << std::endl;
+      }
+
+      std::pair<bool, decomposed_matroid*> results[2];
+      detail::summand_decomposition <matroid_permuted <summand_matroid_type>, matrix_permuted <summand_matrix_type>,
+          summand_matroid_type, summand_matrix_type> summands =
+      { permuted_upper_left_matroid, permuted_upper_left_matrix, upper_left_extra_elements, &nested_minors,
+          lower_right_matroid, lower_right_matrix, lower_right_extra_elements, construct_decomposition, log,
+          cancelled, results };
+      /// Pivots in the summands may rename elements of the separated matroid, which they refer to.
+      matroid_element_set elements;
+      if (construct_decomposition)
+        elements = matroid_elements(permuted_matroid);
+      detail::decompose_summands(summands);
+
+      if (log.is_progressive())
+      {
+        log.unindent();
+      }
+
+      if (construct_decomposition)
+      {
+        int type = sep.rank() == 0 ? static_cast<int>(decomposed_matroid_separator::ONE_SEPARATION)
+            : static_cast<int>(decomposed_matroid_separator::TWO_SEPARATION);
+
+        return std::pair<bool, decomposed_matroid*>(results[0].first && results[1].first,
+            new decomposed_matroid_separator(results[0].second, results[1].second, type, elements,
+                extra_elements));
+      }
+      else
+        return std::pair<bool, decomposed_matroid*>(results[0].first && results[1].first, NULL);
+    }
+
+    if (log.is_verbose())
+    {
+      std::cout << "Constructed sequence of " << (nested_minors.size() + 1)
+          << " 3-connected nested minors starting with W3." << std::endl;
+    }
+
+
+    size_t new_size = std::max(graphicness.largest_graphic_minor(), graphicness.largest_cographic_minor());
     if (log.is_progressive())
     {
       log.line() << ", (CO)GRAPHIC LEN: " << new_size;
@@ -291,10 +463,10 @@ namespace tu
         std::cout << "Found a (3|4)-separation." << std::endl;
       }
 
-      integer_matroid upper_left_matroid;
-      integer_matrix upper_left_matrix;
-      integer_matroid lower_right_matroid;
-      integer_matrix lower_right_matrix;
+      summand_matroid_type upper_left_matroid;
+      summand_matrix_type upper_left_matrix;
+      summand_matroid_type lower_right_matroid;
+      summand_matrix_type lower_right_matrix;
 
       sep.create_components(permuted_matroid, permuted_matrix, upper_left_matroid, upper_left_matrix,
           lower_right_matroid, lower_right_matrix);
@@ -305,23 +477,19 @@ namespace tu
             << lower_right_matrix.size1() << " x " << lower_right_matrix.size2() << "." << std::endl;
       }
 
-      matroid_permuted<integer_matroid> permuted_upper_left_matroid(upper_left_matroid);
-      matrix_permuted<integer_matrix> permuted_upper_left_matrix(upper_left_matrix);
+      matroid_permuted <summand_matroid_type> permuted_upper_left_matroid(upper_left_matroid);
+      matrix_permuted <summand_matrix_type> permuted_upper_left_matrix(upper_left_matrix);
 
-      std::pair<bool, decomposed_matroid*> upper_left_result = decompose_binary_matroid(permuted_upper_left_matroid,
-          permuted_upper_left_matrix, extra_elements, construct_decomposition, log);
-
-      if (!construct_decomposition && !upper_left_result.first)
-      {
-        if (log.is_progressive())
-        {
-          log.unindent();
-        }
-        return std::pair<bool, decomposed_matroid*>(false, NULL);
-      }
-
-      std::pair<bool, decomposed_matroid*> lower_right_result = decompose_binary_matroid(lower_right_matroid,
-          lower_right_matrix, extra_elements, construct_decomposition, log);
+      std::pair<bool, decomposed_matroid*> results[2];
+      detail::summand_decomposition <matroid_permuted <summand_matroid_type>, matrix_permuted <summand_matrix_type>,
+          summand_matroid_type, summand_matrix_type> summands =
+      { permuted_upper_left_matroid, permuted_upper_left_matrix, extra_elements, NULL, lower_right_matroid,
+          lower_right_matrix, extra_elements, construct_decomposition, log, cancelled, results };
+      /// Pivots in the summands may rename elements of the separated matroid, which they refer to.
+      matroid_element_set elements;
+      if (construct_decomposition)
+        elements = matroid_elements(permuted_matroid);
+      detail::decompose_summands(summands);
 
       if (log.is_progressive())
       {
@@ -329,12 +497,11 @@ namespace tu
       }
 
       if (construct_decomposition)
-        return std::make_pair(lower_right_result.first && upper_left_result.first,
-            (decomposed_matroid *) (new decomposed_matroid_separator(upper_left_result.second,
-                lower_right_result.second, decomposed_matroid_separator::THREE_SEPARATION, matroid_elements(
-                    permuted_matroid), extra_elements)));
+        return std::make_pair(results[0].first && results[1].first,
+            (decomposed_matroid *) (new decomposed_matroid_separator(results[0].second, results[1].second,
+                decomposed_matroid_separator::THREE_SEPARATION, elements, extra_elements)));
       else
-        return std::pair<bool, decomposed_matroid*>(lower_right_result.first, NULL);
+        return std::pair<bool, decomposed_matroid*>(results[0].first && results[1].first, NULL);
     }
 
     if (construct_decomposition)
@@ -477,15 +644,20 @@ namespace tu
    * @param matroid
    * @param matrix
    * @param construct_decomposition
+   * @param log
+   * @param cancelled If not NULL, then the decomposition stops early once this flag is set
    * @return
    */
 
   template <typename MatroidType, typename MatrixType>
   std::pair<bool, decomposed_matroid*> decompose_binary_matroid(MatroidType& matroid, MatrixType& matrix,
-      matroid_element_set extra_elements, bool construct_decomposition, logger& log)
+      matroid_element_set extra_elements, bool construct_decomposition, logger& log, std::atomic <bool>* cancelled)
   {
     assert(is_zero_one_matrix(matrix));
 
+    if (cancelled && *cancelled)
+      return std::pair<bool, decomposed_matroid*>(false, NULL);
+
     if (log.is_progressive())
     {
       log.clear();
@@ -527,6 +699,8 @@ namespace tu
 
     typedef matroid_permuted<MatroidType> permuted_matroid_type;
     typedef matrix_permuted<MatrixType> permuted_marix_type;
+    typedef matroid_summand <typename detail::summand_traits <MatroidType>::root_type> summand_matroid_type;
+    typedef matrix_summand <typename detail::summand_traits <MatrixType>::root_type> summand_matrix_type;
 
     permuted_matroid_type permuted_matroid(matroid);
     permuted_marix_type permuted_matrix(matrix);
@@ -560,10 +734,10 @@ namespace tu
         std::cout << "Found a " << (sep.rank() + 1) << "-separation instead." << std::endl;
       }
 
-      integer_matroid upper_left_matroid;
-      integer_matrix upper_left_matrix;
-      integer_matroid lower_right_matroid;
-      integer_matrix lower_right_matrix;
+      summand_matroid_type upper_left_matroid;
+      summand_matrix_type upper_left_matrix;
+      summand_matroid_type lower_right_matroid;
+      summand_matrix_type lower_right_matrix;
 
       sep.create_components(permuted_matroid, permuted_matrix, upper_left_matroid, upper_left_matrix,
           lower_right_matroid, lower_right_matrix);
@@ -572,8 +746,8 @@ namespace tu
       matroid_element_set upper_left_extra_elements, lower_right_extra_elements;
       if (sep.rank() == 0 && false)
       {
-        matroid_element_set upper_left_elements = upper_left_matroid.get_elements();
-        matroid_element_set lower_right_elements = lower_right_matroid.get_elements();
+        matroid_element_set upper_left_elements = matroid_elements(upper_left_matroid);
+        matroid_element_set lower_right_elements = matroid_elements(lower_right_matroid);
 
         std::set_difference(extra_elements.begin(), extra_elements.end(), lower_right_elements.begin(),
             lower_right_elements.end(), std::inserter(upper_left_extra_elements, upper_left_extra_elements.end()));
@@ -594,20 +768,16 @@ namespace tu
             << lower_right_matrix.size1() << " x " << lower_right_matrix.size2() << "." << std::endl;
       }
 
-      std::pair<bool, decomposed_matroid*> upper_left_result = decompose_binary_matroid(upper_left_matroid,
-          upper_left_matrix, upper_left_extra_elements, construct_decomposition, log);
-
-      if (!construct_decomposition && !upper_left_result.first)
-      {
-        if (log.is_progressive())
-        {
-          log.unindent();
-        }
-        return std::pair<bool, decomposed_matroid*>(false, NULL);
-      }
-
-      std::pair<bool, decomposed_matroid*> lower_right_result = decompose_binary_matroid(lower_right_matroid,
-          lower_right_matrix, lower_right_extra_elements, construct_decomposition, log);
+      std::pair<bool, decomposed_matroid*> results[2];
+      detail::summand_decomposition <summand_matroid_type, summand_matrix_type, summand_matroid_type,
+          summand_matrix_type> summands = { upper_left_matroid, upper_left_matrix, upper_left_extra_elements, NULL,
+          lower_right_matroid, lower_right_matrix, lower_right_extra_elements, construct_decomposition, log, cancelled,
+          results };
+      /// Pivots in the summands may rename elements of the separated matroid, which they refer to.
+      matroid_element_set elements;
+      if (construct_decomposition)
+        elements = matroid_elements(permuted_matroid);
+      detail::decompose_summands(summands);
 
       if (log.is_progressive())
       {
@@ -619,12 +789,12 @@ namespace tu
         int type = sep.rank() == 0 ? static_cast<int>(decomposed_matroid_separator::ONE_SEPARATION)
             : static_cast<int>(decomposed_matroid_separator::TWO_SEPARATION);
 
-        return std::pair<bool, decomposed_matroid*>(lower_right_result.first && upper_left_result.first,
-            new decomposed_matroid_separator(upper_left_result.second, lower_right_result.second, type,
-                matroid_elements(permuted_matroid), extra_elements));
+        return std::pair<bool, decomposed_matroid*>(results[0].first && results[1].first,
+            new decomposed_matroid_separator(results[0].second, results[1].second, type, elements,
+                extra_elements));
       }
       else
-        return std::pair<bool, decomposed_matroid*>(lower_right_result.first && upper_left_result.first, NULL);
+        return std::pair<bool, decomposed_matroid*>(results[0].first && results[1].first, NULL);
     }
 
     if (log.is_verbose())
@@ -636,7 +806,7 @@ namespace tu
     nested_minor_sequence nested_minors;
 
     return decompose_with_minor_sequence(permuted_matroid, permuted_matrix, nested_minors, extra_elements,
-        construct_decomposition, log);
+        construct_decomposition, log, cancelled);
   }
 
 } /* namespace tu */
@@ -1,6 +1,9 @@
 #pragma once
 
 #include <vector>
+#include <stdint.h>
+
+#include <boost/dynamic_bitset.hpp>
 
 #include <tu/permutations.hpp>
 
@@ -8,15 +11,17 @@ namespace tu
 {
 
   /**
-   * Models a binary linear vector space by storing all vectors contained in the vector space to quickly
-   * test for membership. Space consumption is O(length * 2 ^ dimension).
+   * Models a binary linear vector space by a basis in reduced row-echelon form whose vectors are packed into
+   * 64-bit words. Each basis vector has a pivot position at which all other basis vectors are zero, and it stores
+   * its coordinates with respect to the inserted vectors. Membership tests and insertions take O(dimension * words)
+   * time and space consumption is O(length * dimension).
    */
 
   class binary_linear_space
   {
   public:
 
-    typedef std::vector <bool> vector_type;
+    typedef boost::dynamic_bitset <uint64_t> vector_type;
 
     /**
      * Contructs a binary linear vector space containing
@@ -25,37 +30,41 @@ namespace tu
      * @param length Length of each vector in the space.
      */
 
-    explicit binary_linear_space(size_t length)
+    explicit binary_linear_space(size_t length) :
+      _length(length), _dimension(0), _scratch(length)
     {
-      _length = length;
-      _dimension = 0;
-      _vectors.push_back(vector_type(length, false));
+
     }
 
     /**
-     * Copy constructor which copies all vectors.
+     * Removes all vectors and changes the length of the vectors while keeping allocated memory.
      *
-     * @param other Instance of another binary linear vector space.
+     * @param length Length of each vector in the space.
      */
 
-    binary_linear_space(const binary_linear_space& other)
+    void clear(size_t length)
     {
-      _length = other._length;
-      _dimension = other._dimension;
-      _vectors.clear();
-      _vectors.reserve(other.vectors());
-      std::copy(other._vectors.begin(), other._vectors.end(), std::back_inserter(_vectors));
+      _length = length;
+      _dimension = 0;
+      _scratch.resize(length);
     }
 
     /**
      * Read-only access to the vectors in this vector space.
      *
-     * @param index Index in range [0, vectors() )
+     * @param index Index in range [0, vectors() ), whose bits indicate the inserted vectors to be summed up.
+     * @return The vector with the given index
      */
 
-    const vector_type& operator[](size_t index) const
+    vector_type operator[](size_t index) const
     {
-      return _vectors[index];
+      vector_type result(_length);
+      for (size_t i = 0; i < _dimension; ++i)
+      {
+        if ((index >> i) & 1)
+          result ^= _inserted[i];
+      }
+      return result;
     }
 
     /**
@@ -73,7 +82,7 @@ namespace tu
 
     inline size_t vectors() const
     {
-      return _vectors.size();
+      return size_t(1) << _dimension;
     }
 
     /**
@@ -97,10 +106,11 @@ namespace tu
     {
       assert (vector.size() == length());
 
-      if (is_spanned(vector))
+      reduce(vector);
+      if (_scratch.none())
         return false;
 
-      insert(vector);
+      insert_reduced();
       return true;
     }
 
@@ -115,83 +125,130 @@ namespace tu
     {
       assert (vector.size() == length());
 
-      size_t begin = 1 << _dimension;
-      ++_dimension;
-      size_t end = 1 << _dimension;
-      _vectors.resize(end, vector);
-      for (size_t current = begin + 1; current < end; current++)
-        vector_sum(vector, _vectors[current - begin], _vectors[current]);
+      reduce(vector);
+      assert (_scratch.any());
+      insert_reduced();
     }
 
     /**
      * Searches a given vector in this vector space.
      *
      * @param vector Given vector of appropriate size
-     * @return Index of the given vector or -1 if it is not spanned.
+     * @return Index of the given vector or -1 if it is not spanned. The bits of the index indicate the inserted
+     *         vectors whose sum is the given vector.
      */
 
     int find(const vector_type& vector) const
     {
       assert (vector.size() == length());
+      assert (_dimension < 8 * sizeof(int) - 1);
 
-      for (size_t j = 0; j < _vectors.size(); ++j)
+      reduce(vector);
+      if (_scratch.any())
+        return -1;
+
+      int index = 0;
+      for (size_t i = 0; i < _dimension; ++i)
       {
-        const vector_type& current_vector = _vectors[j];
-        bool same = true;
-        for (size_t i = 0; i < _length; ++i)
-        {
-          if (current_vector[i] ? !vector[i] : vector[i])
-          {
-            same = false;
-            break;
-          }
-        }
-        if (same)
-          return j;
+        if (_scratch_coordinates.test(i))
+          index |= 1 << i;
       }
-      return -1;
+      return index;
     }
 
     /**
      * Tests whether a given vector is spanned by this vector space.
      *
      * @param vector A given vector of appropriate size
-     * @return
+     * @return true if and only if the vector is spanned.
      */
 
     inline bool is_spanned(const vector_type& vector) const
     {
       assert (vector.size() == length());
 
-      return find(vector) >= 0;
+      reduce(vector);
+      return _scratch.none();
     }
 
   protected:
 
     /**
-     * Calculates the sum of two binary vectors and stores
-     * it in a third one. All must have the same size.
-     *
-     * @param first First summand vector
-     * @param second Second summand vector
-     * @param result Vector containing the result
+     * A basis vector together with its pivot position and its coordinates with respect to the inserted vectors.
      */
 
-    static void vector_sum(const vector_type& first, const vector_type& second, vector_type& result)
+    struct basis_vector
     {
-      assert (first.size() == second.size());
-      assert (first.size() == result.size());
+      vector_type vector;
+      vector_type coordinates;
+      size_t pivot;
+    };
 
-      for (size_t i = 0; i < first.size(); ++i)
+    /**
+     * Reduces a given vector by the basis, storing the remainder and the coordinates of the subtracted part in the
+     * scratch vectors.
+     */
+
+    void reduce(const vector_type& vector) const
+    {
+      _scratch = vector;
+      _scratch_coordinates.resize(_dimension);
+      _scratch_coordinates.reset();
+      for (size_t i = 0; i < _dimension; ++i)
       {
-        result[i] = first[i] ? !second[i] : second[i];
+        if (_scratch.test(_basis[i].pivot))
+        {
+          _scratch ^= _basis[i].vector;
+          _scratch_coordinates ^= _basis[i].coordinates;
+        }
+      }
+    }
+
+    /**
+     * Inserts the nonzero remainder of the last reduction as a new basis vector, keeping the basis reduced.
+     */
+
+    void insert_reduced()
+    {
+      if (_basis.size() <= _dimension)
+      {
+        _basis.resize(_dimension + 1);
+        _inserted.resize(_dimension + 1);
       }
+
+      /// The original vector is the remainder plus the subtracted part.
+      basis_vector& inserted = _basis[_dimension];
+      _inserted[_dimension] = _scratch;
+      for (size_t i = 0; i < _dimension; ++i)
+      {
+        if (_scratch_coordinates.test(i))
+          _inserted[_dimension] ^= _inserted[i];
+      }
+      inserted.pivot = _scratch.find_first();
+      inserted.vector = _scratch;
+      inserted.coordinates = _scratch_coordinates;
+      inserted.coordinates.resize(_dimension + 1);
+      inserted.coordinates.set(_dimension);
+
+      for (size_t i = 0; i < _dimension; ++i)
+      {
+        _basis[i].coordinates.resize(_dimension + 1);
+        if (_basis[i].vector.test(inserted.pivot))
+        {
+          _basis[i].vector ^= inserted.vector;
+          _basis[i].coordinates ^= inserted.coordinates;
+        }
+      }
+      ++_dimension;
     }
 
   private:
     size_t _length;
     size_t _dimension;
-    std::vector <vector_type> _vectors;
+    std::vector <basis_vector> _basis;
+    std::vector <vector_type> _inserted;
+    mutable vector_type _scratch;
+    mutable vector_type _scratch_coordinates;
   };
 
   /**
@@ -206,9 +263,10 @@ namespace tu
   {
     for (size_t i = 0; i < space.vectors(); ++i)
     {
+      binary_linear_space::vector_type vector = space[i];
       for (size_t j = 0; j < space.length(); ++j)
       {
-        stream << ' ' << (space[i][j] ? '1' : '0');
+        stream << ' ' << (vector[j] ? '1' : '0');
       }
       stream << '\n';
     }
@@ -1,14 +1,187 @@
+#include "determinant.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <limits>
 #include <map>
+#include <mutex>
+#include <stdexcept>
 #include <vector>
 
-#include <boost/numeric/ublas/lu.hpp>
 #include <boost/dynamic_bitset.hpp>
 
 #include <tu/total_unimodularity.hpp>
-#include "combinations.hpp"
+#include "parallel.hpp"
 
 namespace tu
 {
+  namespace detail
+  {
+
+#if defined(__GNUC__) || defined(__clang__)
+
+    /**
+     * Computes first * second - third * fourth.
+     *
+     * @return false if and only if an intermediate value overflowed
+     */
+
+    template <typename T>
+    inline bool checked_product_difference(T first, T second, T third, T fourth, T& result)
+    {
+      T left, right;
+      return !__builtin_mul_overflow(first, second, &left) && !__builtin_mul_overflow(third, fourth, &right)
+          && !__builtin_sub_overflow(left, right, &result);
+    }
+
+#else
+
+    /**
+     * Computes first * second.
+     *
+     * @return false if and only if the product overflowed
+     */
+
+    template <typename T>
+    inline bool checked_product(T first, T second, T& result)
+    {
+      const T max = std::numeric_limits <T>::max();
+      const T min = std::numeric_limits <T>::min();
+      if (first > 0 ? (second > 0 ? first > max / second : second < min / first)
+          : (second > 0 ? first < min / second : first != 0 && second < max / first))
+      {
+        return false;
+      }
+      result = first * second;
+      return true;
+    }
+
+    /**
+     * Computes first * second - third * fourth without compiler support for overflow checks.
+     *
+     * @return false if and only if an intermediate value overflowed
+     */
+
+    template <typename T>
+    inline bool checked_product_difference(T first, T second, T third, T fourth, T& result)
+    {
+      T left, right;
+      if (!checked_product(first, second, left) || !checked_product(third, fourth, right))
+        return false;
+      if (right < 0 ? left > std::numeric_limits <T>::max() + right : left < std::numeric_limits <T>::min() + right)
+        return false;
+      result = left - right;
+      return true;
+    }
+
+#endif
+
+    /**
+     * Computes the determinant of a square matrix by fraction-free Gaussian elimination, overwriting the entries.
+     *
+     * @param entries Row-major entries of the matrix
+     * @param size Number of rows and columns
+     * @param result Returns the determinant
+     * @return false if and only if an intermediate value overflowed
+     */
+
+    template <typename T>
+    bool determinant_engine::bareiss(T* entries, size_t size, T& result)
+    {
+      T previous = 1;
+      bool negate = false;
+      for (size_t k = 0; k + 1 < size; ++k)
+      {
+        T* pivotRow = &entries[k * size];
+
+        /// Find a nonzero pivot in column k.
+        if (pivotRow[k] == 0)
+        {
+          size_t p = k + 1;
+          while (p < size && entries[p * size + k] == 0)
+            ++p;
+          if (p == size)
+          {
+            result = 0;
+            return true;
+          }
+          for (size_t j = k; j < size; ++j)
+            std::swap(pivotRow[j], entries[p * size + j]);
+          negate = !negate;
+        }
+
+        /// Eliminate below the pivot. All divisions are exact.
+        const T pivot = pivotRow[k];
+        for (size_t i = k + 1; i < size; ++i)
+        {
+          T* row = &entries[i * size];
+          const T factor = row[k];
+          for (size_t j = k + 1; j < size; ++j)
+          {
+            T difference;
+            if (!checked_product_difference(row[j], pivot, factor, pivotRow[j], difference))
+              return false;
+            row[j] = difference / previous;
+          }
+        }
+        previous = pivot;
+      }
+
+      result = size == 0 ? 1 : entries[size * size - 1];
+      if (negate)
+        result = -result;
+      return true;
+    }
+
+    long long determinant_engine::operator()(const integer_matrix& matrix, const size_t* rows, const size_t* columns,
+        size_t size)
+    {
+      _narrow.resize(size * size);
+      for (size_t r = 0; r < size; ++r)
+      {
+        for (size_t c = 0; c < size; ++c)
+          _narrow[r * size + c] = matrix(rows[r], columns[c]);
+      }
+
+      long long result;
+      if (bareiss(&_narrow[0], size, result))
+        return result;
+
+#ifdef __SIZEOF_INT128__
+      _wide.resize(size * size);
+      for (size_t r = 0; r < size; ++r)
+      {
+        for (size_t c = 0; c < size; ++c)
+          _wide[r * size + c] = matrix(rows[r], columns[c]);
+      }
+
+      __int128 wideResult;
+      if (bareiss(&_wide[0], size, wideResult) && wideResult >= std::numeric_limits<long long>::min()
+          && wideResult <= std::numeric_limits<long long>::max())
+      {
+        return (long long) wideResult;
+      }
+#endif
+
+      throw std::overflow_error("Subdeterminant exceeds the range of long long.");
+    }
+
+    long long determinant_engine::operator()(const integer_matrix& matrix, const submatrix_indices& submatrix)
+    {
+      assert(submatrix.rows.size() == submatrix.columns.size());
+
+      const size_t size = submatrix.rows.size();
+      std::vector <size_t> indices(2 * size);
+      for (size_t i = 0; i < size; ++i)
+      {
+        indices[i] = submatrix.rows[i];
+        indices[size + i] = submatrix.columns[i];
+      }
+      return (*this)(matrix, &indices[0], &indices[size], size);
+    }
+
+  } /* namespace detail */
 
   /**
    * Calculates a subdeterminant of the given matrix.
@@ -18,32 +191,29 @@ namespace tu
    * @return The submatrix' determinant
    */
 
-  int submatrix_determinant(const integer_matrix& matrix, const submatrix_indices& submatrix)
+  long long submatrix_determinant(const integer_matrix& matrix, const submatrix_indices& submatrix)
   {
-    typedef boost::numeric::ublas::matrix_indirect <const integer_matrix, submatrix_indices::indirect_array_type> indirect_matrix_t;
+    detail::determinant_engine engine;
 
-    assert (submatrix.rows.size() == submatrix.columns.size());
-
-    const indirect_matrix_t indirect_matrix(matrix, submatrix.rows, submatrix.columns);
-
-    boost::numeric::ublas::matrix <float> float_matrix(indirect_matrix);
-    boost::numeric::ublas::permutation_matrix <size_t> permutation_matrix(float_matrix.size1());
+    return engine(matrix, submatrix);
+  }
 
-    /// LU-factorize
-    int result = boost::numeric::ublas::lu_factorize(float_matrix, permutation_matrix);
-    if (result != 0)
-      return 0;
+  /**
+   * Calculates several subdeterminants of the given matrix, reusing the scratch memory.
+   *
+   * @param matrix A given integer matrix
+   * @param submatrices Matrix-indices describing the submatrices
+   * @param determinants Returns the submatrices' determinants in the same order
+   */
 
-    /// Calculate the determinant as a product of the diagonal entries, taking the permutation matrix into account.
-    float det = 1.0f;
-    for (size_t i = 0; i < float_matrix.size1(); ++i)
-    {
-      det *= float_matrix(i, i);
-      if (i != permutation_matrix(i))
-        det = -det;
-    }
+  void submatrix_determinants(const integer_matrix& matrix, const std::vector <submatrix_indices>& submatrices,
+      std::vector <long long>& determinants)
+  {
+    detail::determinant_engine engine;
 
-    return (int) det;
+    determinants.resize(submatrices.size());
+    for (size_t i = 0; i < submatrices.size(); ++i)
+      determinants[i] = engine(matrix, submatrices[i]);
   }
 
   /**
@@ -90,6 +260,201 @@ namespace tu
     return (count % 4 == 0);
   }
 
+  namespace detail
+  {
+
+    /**
+     * State shared by the threads of a Camion enumeration. The best violator is the smallest one, ties being broken
+     * by lexicographic order of rows and then columns, such that the result does not depend on the scheduling.
+     */
+
+    struct camion_shared_state
+    {
+      std::atomic <size_t> next_row;
+      std::atomic <size_t> best_size;
+      std::mutex mutex;
+      std::vector <size_t> best_rows;
+      std::vector <size_t> best_columns;
+    };
+
+    /**
+     * Enumerates Eulerian square submatrices whose first row is given and checks Camion's criterion for them. Row
+     * sets are built incrementally by depth-first search, maintaining for each column the parity and the sum of its
+     * entries in the current rows. Only columns with even parity can be part of an Eulerian submatrix with these
+     * rows, so the column subsets are chosen among those, again maintaining row parities and the total sum
+     * incrementally. All buffers are reused.
+     */
+
+    class camion_search
+    {
+    public:
+      camion_search(const integer_matrix& matrix, camion_shared_state& shared) :
+        _matrix(matrix), _shared(shared), _column_parity(matrix.size2(), 0), _column_sum(matrix.size2(), 0),
+            _row_parity(matrix.size1(), 0), _num_odd_rows(0), _sum(0)
+      {
+        _rows.reserve(matrix.size1());
+        _columns.reserve(matrix.size2());
+        _even_columns.reserve(matrix.size2());
+      }
+
+      /**
+       * Processes all submatrices whose first row is the given one.
+       */
+
+      void run(size_t first_row)
+      {
+        add_row(first_row);
+        search_rows(first_row + 1);
+        remove_row(first_row);
+      }
+
+    private:
+      void add_row(size_t row)
+      {
+        _rows.push_back(row);
+        for (size_t column = 0; column < _matrix.size2(); ++column)
+        {
+          long long value = _matrix(row, column);
+          _column_parity[column] ^= value & 1;
+          _column_sum[column] += value;
+        }
+      }
+
+      void remove_row(size_t row)
+      {
+        assert(_rows.back() == row);
+        _rows.pop_back();
+        for (size_t column = 0; column < _matrix.size2(); ++column)
+        {
+          long long value = _matrix(row, column);
+          _column_parity[column] ^= value & 1;
+          _column_sum[column] -= value;
+        }
+      }
+
+      void toggle_column(size_t column)
+      {
+        for (size_t i = 0; i < _rows.size(); ++i)
+        {
+          if (_matrix(_rows[i], column) & 1)
+          {
+            _row_parity[_rows[i]] ^= 1;
+            if (_row_parity[_rows[i]])
+              ++_num_odd_rows;
+            else
+              --_num_odd_rows;
+          }
+        }
+      }
+
+      void search_rows(size_t next_row)
+      {
+        /// A larger violator can never replace a known one.
+        if (_rows.size() > _shared.best_size.load())
+          return;
+
+        search_columns();
+
+        if (_rows.size() >= _shared.best_size.load() || _rows.size() >= _matrix.size2())
+          return;
+
+        for (size_t row = next_row; row < _matrix.size1(); ++row)
+        {
+          add_row(row);
+          search_rows(row + 1);
+          remove_row(row);
+        }
+      }
+
+      void search_columns()
+      {
+        _even_columns.clear();
+        for (size_t column = 0; column < _matrix.size2(); ++column)
+        {
+          if (!_column_parity[column])
+            _even_columns.push_back(column);
+        }
+        if (_even_columns.size() < _rows.size())
+          return;
+
+        assert(_columns.empty() && _num_odd_rows == 0 && _sum == 0);
+        search_columns(0);
+      }
+
+      bool search_columns(size_t next)
+      {
+        const size_t size = _rows.size();
+        if (_columns.size() == size)
+        {
+          if (_num_odd_rows == 0 && _sum % 4 != 0)
+          {
+            report();
+            return true;
+          }
+          return false;
+        }
+
+        for (size_t i = next; i + size <= _even_columns.size() + _columns.size(); ++i)
+        {
+          size_t column = _even_columns[i];
+          _columns.push_back(column);
+          toggle_column(column);
+          _sum += _column_sum[column];
+          bool found = search_columns(i + 1);
+          _sum -= _column_sum[column];
+          toggle_column(column);
+          _columns.pop_back();
+          if (found)
+            return true;
+        }
+        return false;
+      }
+
+      void report()
+      {
+        std::lock_guard <std::mutex> lock(_shared.mutex);
+
+        const size_t size = _rows.size();
+        if (size < _shared.best_size.load() || (size == _shared.best_size.load() && std::make_pair(_rows, _columns)
+            < std::make_pair(_shared.best_rows, _shared.best_columns)))
+        {
+          _shared.best_rows = _rows;
+          _shared.best_columns = _columns;
+          _shared.best_size.store(size);
+        }
+      }
+
+      const integer_matrix& _matrix;
+      camion_shared_state& _shared;
+      std::vector <size_t> _rows;
+      std::vector <size_t> _columns;
+      std::vector <size_t> _even_columns;
+      std::vector <char> _column_parity;
+      std::vector <long long> _column_sum;
+      std::vector <char> _row_parity;
+      size_t _num_odd_rows;
+      long long _sum;
+    };
+
+    /**
+     * Worker that processes first rows until none are left.
+     */
+
+    struct camion_worker
+    {
+      const integer_matrix& matrix;
+      camion_shared_state& shared;
+
+      void operator()(size_t thread) const
+      {
+        camion_search search(matrix, shared);
+        for (size_t row = shared.next_row++; row < matrix.size1(); row = shared.next_row++)
+          search.run(row);
+      }
+    };
+
+  } /* namespace detail */
+
   /**
    * Checks all subdeterminants to test a given matrix for total unimodularity.
    *
@@ -108,6 +473,10 @@ namespace tu
    * Checks all subdeterminants to test a given matrix for total unimodularity.
    * If this is not the case, violator describes a violating submatrix.
    *
+   * By Camion's criterion, it suffices to check that every Eulerian square submatrix has an entry sum divisible by 4.
+   * The row sets are distributed among threads by their first row. If the matrix is not totally unimodular, then
+   * violator is the smallest violating submatrix whose rows and then columns are lexicographically minimal.
+   *
    * @param matrix The given matrix
    * @param violator The violating submatrix, if the result is false
    * @return true if and only if the this matrix is totally unimodular
@@ -115,44 +484,25 @@ namespace tu
 
   bool determinant_is_totally_unimodular(const integer_matrix& matrix, submatrix_indices& violator)
   {
-    for (size_t size = 1; size <= matrix.size1(); ++size)
-    {
-      combination row_combination(matrix.size1(), size);
-      while (true)
-      {
-        combination column_combination(matrix.size2(), size);
-        while (true)
-        {
-          submatrix_indices sub;
-          submatrix_indices::vector_type indirect_array(size);
-          for (size_t i = 0; i < size; ++i)
-            indirect_array[i] = row_combination[i];
-          sub.rows = submatrix_indices::indirect_array_type(size, indirect_array);
-          for (size_t i = 0; i < size; ++i)
-          {
-            indirect_array[i] = column_combination[i];
-          }
-          sub.columns = submatrix_indices::indirect_array_type(size, indirect_array);
+    detail::camion_shared_state shared;
+    shared.next_row = 0;
+    shared.best_size = std::numeric_limits <size_t>::max();
 
-          /// Examine the determinant
-          bool camion = submatrix_camion(matrix, sub);
+    detail::camion_worker worker = { matrix, shared };
+    detail::run_reserved_worker_threads(detail::num_worker_threads(matrix.size1()), worker);
 
-          if (!camion)
-          {
-            violator = sub;
-            return false;
-          }
+    if (shared.best_rows.empty())
+      return true;
 
-          if (column_combination.is_last())
-            break;
-          column_combination.next();
-        }
-        if (row_combination.is_last())
-          break;
-        row_combination.next();
-      }
-    }
-    return true;
+    const size_t size = shared.best_rows.size();
+    submatrix_indices::vector_type indirect_array(size);
+    for (size_t i = 0; i < size; ++i)
+      indirect_array[i] = shared.best_rows[i];
+    violator.rows = submatrix_indices::indirect_array_type(size, indirect_array);
+    for (size_t i = 0; i < size; ++i)
+      indirect_array[i] = shared.best_columns[i];
+    violator.columns = submatrix_indices::indirect_array_type(size, indirect_array);
+    return false;
   }
 
 } /* namespace tu */
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <vector>
+
+#include <tu/common.hpp>
+
+namespace tu
+{
+  namespace detail
+  {
+
+    /**
+     * Exact computation of subdeterminants by fraction-free (Bareiss) elimination. The entries are copied into a
+     * scratch buffer that is reused between calls, such that evaluating many submatrices of the same matrix does not
+     * allocate memory. Computations are carried out on long long and repeated with 128-bit integers if an
+     * intermediate value overflows.
+     */
+
+    class determinant_engine
+    {
+    public:
+
+      /**
+       * Calculates the determinant of the square submatrix given by row and column indices.
+       *
+       * @param matrix A given integer matrix
+       * @param rows Array of row indices
+       * @param columns Array of column indices
+       * @param size Number of rows and columns of the submatrix
+       * @return The submatrix' determinant
+       * @throws std::overflow_error if the determinant cannot be computed exactly
+       */
+
+      long long operator()(const integer_matrix& matrix, const size_t* rows, const size_t* columns, size_t size);
+
+      /**
+       * Calculates a subdeterminant of the given matrix.
+       *
+       * @param matrix A given integer matrix
+       * @param submatrix Matrix-indices describing a square submatrix
+       * @return The submatrix' determinant
+       * @throws std::overflow_error if the determinant cannot be computed exactly
+       */
+
+      long long operator()(const integer_matrix& matrix, const submatrix_indices& submatrix);
+
+    private:
+      template <typename T>
+      static bool bareiss(T* entries, size_t size, T& result);
+
+      std::vector <long long> _narrow;
+#ifdef __SIZEOF_INT128__
+      std::vector <__int128> _wide;
+#endif
+    };
+
+  } /* namespace detail */
+
+  /**
+   * Checks Camion's criterion for total unimodularity.
+   *
+   * @param matrix A given integer matrix
+   * @param submatrix Matrix-indices describing a square submatrix B of A
+   * @return true iff B is not Eulerian or 1^T * B * 1 = 0 (mod 4)
+   */
+
+  bool submatrix_camion(const integer_matrix& matrix, const submatrix_indices& submatrix);
+
+} /* namespace tu */
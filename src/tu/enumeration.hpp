@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <vector>
 
 #include "separation.hpp"
@@ -10,6 +11,7 @@
 #include "bipartite_graph_bfs.hpp"
 #include "matrix_modified.hpp"
 #include "logger.hpp"
+#include "parallel.hpp"
 
 namespace tu
 {
@@ -487,104 +489,288 @@ namespace tu
       return nested_minors.size();
     }
 
+    typedef signed char mapping_value_t;
+
     /**
-     * Enumerates all necessary partitions for a fixed extension inside a sequence of nested minors.
-     * It works on a separate matrix with mapping vectors. Those contain either entries +1 and -1
-     * to show to which part of the minor-separation a row or column belongs and a 0 to designate
-     * a row or column to be unspecified.
-     *
-     * @param matroid The given matroid
-     * @param matrix Representation matrix for the given matroid
-     * @param worker_matrix Matrix to work on with the right permutation
-     * @param row_mapping Mapping vector for rows
-     * @param column_mapping Mapping vector for columns
-     * @param minor_size Size of the current minor in the sequence of nested minors
-     * @param ext_height Height of the extension
-     * @param ext_width Width of the extension
-     * @param separation Separation to be returned
-     * @param extra_elements Set of matroid-elements to be filled with pivot-elements
-     * @param enumeration Iteration step in the whole enumeration.
-     * @param next_enumeration Next enumeration
-     * @param max_enumerations Total number of enumerations
-     * @param next_percent Next percent value for a percent-jump
-     * @param log Logger
-     * @param cut Length of the line to cut off the progress-part
-     * @return true if and only if the partitioning algorithm was successful
+     * Progress of an enumeration of partitions. The counter may be increased by all threads, but only the calling
+     * thread writes to the log.
+     */
+
+    struct enumeration_progress
+    {
+      enumeration_progress(logger& log, size_t cut, unsigned long long max_enumerations) :
+        log(log), cut(cut), enumeration(0), next_enumeration(max_enumerations / 100), max_enumerations(max_enumerations),
+            next_percent(1)
+      {
+
+      }
+
+      /**
+       * Prints the percentage if it reached the next step.
+       */
+
+      void report()
+      {
+        if (!log.is_progressive() || enumeration.load() < next_enumeration)
+          return;
+
+        while (next_percent < 100 && enumeration.load() >= next_enumeration)
+        {
+          next_percent++;
+          next_enumeration = (max_enumerations * next_percent) / 100;
+        }
+        log.erase(cut);
+        log.line() << (next_percent - 1) << '%';
+        std::cout << log;
+      }
+
+      logger& log;
+      size_t cut;
+      std::atomic <unsigned long long> enumeration;
+      unsigned long long next_enumeration;
+      unsigned long long max_enumerations;
+      unsigned int next_percent;
+    };
+
+    /**
+     * Partitions of the full enumeration of a minor. Each bit of a bit pattern determines the part of a row or column
+     * of the minor, where unset bits belong to the top-left part T_1. Complementary patterns describe the same
+     * partition with the parts exchanged. Since the partitioning algorithm assigns remaining elements to T_1, it
+     * suffices to consider the patterns with |T_1| <= |T_2|, and those with the last bit set if |T_1| = |T_2|.
      */
 
-    template <typename MatroidType, typename MatrixType, typename MappingValue>
-    inline bool enumerate_extension(MatroidType& matroid, MatrixType& matrix, matrix_permuted <const integer_matrix>& worker_matrix, std::vector <
-        MappingValue>& row_mapping, std::vector <MappingValue>& column_mapping, size_pair_t minor_size, size_t ext_height, size_t ext_width,
-        separation& separation, matroid_element_set& extra_elements, unsigned long long& enumeration, unsigned long long& next_enumeration,
-        unsigned long long max_enumerations, unsigned int& next_percent, logger& log, size_t cut)
+    struct full_enumeration_candidates
     {
-      const size_t minor_length = minor_size.first + minor_size.second;
-      const size_t ext_length = ext_height + ext_width;
+      full_enumeration_candidates(size_pair_t minor_size) :
+        minor_size(minor_size)
+      {
+
+      }
+
+      /**
+       * @return Number of candidates
+       */
+
+      size_t size() const
+      {
+        return size_t(1) << (minor_size.first + minor_size.second - 1);
+      }
+
+      /**
+       * Sets the mappings for the given candidate. Rows and columns outside the minor must already be mapped to 0.
+       *
+       * @return true if and only if the candidate must be tested
+       */
+
+      bool operator()(size_t index, std::vector <mapping_value_t>& row_mapping, std::vector <mapping_value_t>& column_mapping) const
+      {
+        /// Each candidate index represents a pattern with the last bit set and its complement.
+        const size_t length = minor_size.first + minor_size.second;
+        size_t bits = index | (size_t(1) << (length - 1));
+        size_t num_bits = 0;
+        for (size_t i = 0; i < length; ++i)
+          num_bits += (bits >> i) & 0x1;
+        if (2 * num_bits < length)
+          bits = ~bits & ((size_t(1) << length) - 1);
+
+        for (size_t row = 0; row < minor_size.first; ++row)
+        {
+          row_mapping[row] = ((bits >> row) & 0x1) ? 1 : -1;
+        }
+        for (size_t column = 0; column < minor_size.second; ++column)
+        {
+          column_mapping[column] = ((bits >> (minor_size.first + column)) & 0x1) ? 1 : -1;
+        }
+        return true;
+      }
+
+      size_pair_t minor_size;
+    };
+
+    /**
+     * Partitions necessary for a fixed extension inside a sequence of nested minors. The mapping vectors contain
+     * either entries +1 and -1 to show to which part of the minor-separation a row or column belongs and a 0 to
+     * designate a row or column to be unspecified. A candidate index consists of an enumerated element of the smaller
+     * minor (or none) and a nonzero bit pattern for the elements of the extension. Since T_1 has at most 4 elements
+     * and the minor at least 8, all candidates satisfy |T_1| < |T_2| and no complementary pairs occur.
+     */
+
+    struct extension_candidates
+    {
+      extension_candidates(size_pair_t minor_size, size_t ext_height, size_t ext_width) :
+        minor_size(minor_size), ext_height(ext_height), ext_width(ext_width)
+      {
+
+      }
+
+      /**
+       * @return Number of candidates
+       */
+
+      size_t size() const
+      {
+        return (minor_size.first + minor_size.second + 1) * ((size_t(1) << (ext_height + ext_width)) - 1);
+      }
+
+      /**
+       * Sets the mappings for the given candidate.
+       *
+       * @return true if and only if the candidate must be tested
+       */
 
-      for (size_t minor_enum_iter = 0; minor_enum_iter <= minor_length; ++minor_enum_iter)
+      bool operator()(size_t index, std::vector <mapping_value_t>& row_mapping, std::vector <mapping_value_t>& column_mapping) const
       {
+        const size_t minor_length = minor_size.first + minor_size.second;
+        const size_t ext_length = ext_height + ext_width;
+        const size_t minor_enum_iter = index / ((size_t(1) << ext_length) - 1);
+        const size_t bits = 1 + index % ((size_t(1) << ext_length) - 1);
+
         /// Type and index of enumerated element in smaller minor
         bool minor_enum_is_row = minor_enum_iter < minor_size.first;
         bool minor_enum_is_column = !minor_enum_is_row && minor_enum_iter != minor_length;
         size_t minor_enum_index = minor_enum_is_column ? minor_enum_iter - minor_size.first : minor_enum_iter;
 
-        for (size_t bits = 1; bits < (size_t) (1 << ext_length); ++bits)
+        /// Set all mappings to 1 at first
+        std::fill(row_mapping.begin(), row_mapping.begin() + minor_size.first + ext_height, 1);
+        std::fill(row_mapping.begin() + minor_size.first + ext_height, row_mapping.end(), 0);
+        std::fill(column_mapping.begin(), column_mapping.begin() + minor_size.second + ext_width, 1);
+        std::fill(column_mapping.begin() + minor_size.second + ext_width, column_mapping.end(), 0);
+
+        /// Set minor enumerated to -1
+        size_t num_enumerated = 1;
+        if (minor_enum_is_row)
+          row_mapping[minor_enum_index] = -1;
+        else if (minor_enum_is_column)
+          column_mapping[minor_enum_index] = -1;
+        else
+          num_enumerated = 0;
+
+        /// Iterator over extension bits and set row/column mapping to -1 if the bit is set
+        for (size_t ext_enum_iter = 0; ext_enum_iter < ext_length; ++ext_enum_iter)
         {
-          /// Set all mappings to 1 at first
-          std::fill(row_mapping.begin(), row_mapping.begin() + minor_size.first + ext_height, 1);
-          std::fill(row_mapping.begin() + minor_size.first + ext_height, row_mapping.end(), 0);
-          std::fill(column_mapping.begin(), column_mapping.begin() + minor_size.second + ext_width, 1);
-          std::fill(column_mapping.begin() + minor_size.second + ext_width, column_mapping.end(), 0);
-
-          /// Set minor enumerated to -1
-          size_t num_enumerated = 1;
-          if (minor_enum_is_row)
-            row_mapping[minor_enum_index] = -1;
-          else if (minor_enum_is_column)
-            column_mapping[minor_enum_index] = -1;
-          else
-            num_enumerated = 0;
-
-          /// Iterator over extension bits and set row/column mapping to -1 if the bit is set
-          for (size_t ext_enum_iter = 0; ext_enum_iter < ext_length; ++ext_enum_iter)
+          if (((bits >> ext_enum_iter) & 1) == 1)
           {
-            if (((bits >> ext_enum_iter) & 1) == 1)
-            {
-              ++num_enumerated;
-              if (ext_enum_iter < ext_height)
-                row_mapping[minor_size.first + ext_enum_iter] = -1;
-              else
-                column_mapping[minor_size.second + ext_enum_iter - ext_height] = -1;
-            }
+            ++num_enumerated;
+            if (ext_enum_iter < ext_height)
+              row_mapping[minor_size.first + ext_enum_iter] = -1;
+            else
+              column_mapping[minor_size.second + ext_enum_iter - ext_height] = -1;
           }
+        }
 
-          if (num_enumerated < 2)
-            continue;
+        return num_enumerated >= 2;
+      }
+
+      size_pair_t minor_size;
+      size_t ext_height;
+      size_t ext_width;
+    };
+
+    /**
+     * Transforms the mappings into row/column permutations of the worker matrix, starting from the identity such
+     * that the result only depends on the mappings.
+     *
+     * @param worker_matrix Matrix to work on
+     * @param row_mapping Mapping vector for rows
+     * @param column_mapping Mapping vector for columns
+     * @param top_left_size Returns the size of the top-left part
+     * @param bottom_right_size Returns the size of the bottom-right part
+     */
 
-          /// Transform the mappings into row/column permutations.
-          size_pair_t heights = detail::apply_mapping(worker_matrix.perm1(), row_mapping);
-          size_pair_t widths = detail::apply_mapping(worker_matrix.perm2(), column_mapping);
+    inline void apply_mappings(matrix_permuted <const integer_matrix>& worker_matrix, std::vector <mapping_value_t>& row_mapping,
+        std::vector <mapping_value_t>& column_mapping, size_pair_t& top_left_size, size_pair_t& bottom_right_size)
+    {
+      worker_matrix.perm1().reset();
+      worker_matrix.perm2().reset();
+      size_pair_t heights = apply_mapping(worker_matrix.perm1(), row_mapping);
+      size_pair_t widths = apply_mapping(worker_matrix.perm2(), column_mapping);
+      top_left_size = size_pair_t(heights.first, widths.first);
+      bottom_right_size = size_pair_t(heights.second, widths.second);
+    }
 
-          ++enumeration;
+    /**
+     * Worker of a parallel search for the first candidate partition that can be extended to a (3|4)-separation.
+     * Each thread has its own worker matrix and mapping vectors. Candidates are handed out in increasing order and a
+     * thread stops as soon as all remaining candidates come after one that was already successful.
+     */
 
-          if (log.is_progressive() && enumeration == next_enumeration)
-          {
-            log.erase(cut);
-            log.line() << next_percent << "%";
-            std::cout << log;
-            next_percent++;
-            next_enumeration = (max_enumerations * next_percent) / 100;
-          }
+    template <typename Candidates>
+    struct separation_search_worker
+    {
+      const integer_matrix& worker_matrix_base;
+      const Candidates& candidates;
+      std::atomic <size_t>& next_candidate;
+      std::atomic <size_t>& first_found;
+      enumeration_progress& progress;
 
-          if (detail::extend_to_3_4_separation(matroid, matrix, worker_matrix, size_pair_t(heights.first, widths.first), size_pair_t(heights.second,
-              widths.second), separation, extra_elements))
+      void operator()(size_t thread) const
+      {
+        matrix_permuted <const integer_matrix> worker_matrix(worker_matrix_base);
+        std::vector <mapping_value_t> row_mapping(worker_matrix_base.size1(), 0);
+        std::vector <mapping_value_t> column_mapping(worker_matrix_base.size2(), 0);
+
+        for (size_t index = next_candidate++; index < first_found.load(); index = next_candidate++)
+        {
+          if (!candidates(index, row_mapping, column_mapping))
+            continue;
+
+          ++progress.enumeration;
+          if (thread == 0)
+            progress.report();
+
+          size_pair_t top_left_size, bottom_right_size;
+          apply_mappings(worker_matrix, row_mapping, column_mapping, top_left_size, bottom_right_size);
+          rank_distribution ranks = partition(worker_matrix, top_left_size.first, top_left_size.second, bottom_right_size.first,
+              bottom_right_size.second);
+          if (ranks == RANK_TOO_HIGH || top_left_size.first + top_left_size.second < 4 || bottom_right_size.first
+              + bottom_right_size.second < 4)
           {
-            return true;
+            continue;
           }
+
+          size_t found = first_found.load();
+          while (index < found && !first_found.compare_exchange_weak(found, index))
+            ;
         }
       }
+    };
 
-      return false;
+    /**
+     * Tests the given candidate partitions in parallel and applies the first one that can be extended to a
+     * (3|4)-separation. The result is the same as that of testing the candidates in order.
+     *
+     * @param matroid The given matroid
+     * @param matrix Representation matrix for the given matroid
+     * @param worker_matrix Matrix to work on with the right permutation
+     * @param candidates Candidate partitions
+     * @param separation Separation to be returned
+     * @param extra_elements Set of matroid-elements to be filled with pivot-elements
+     * @param progress Progress of the whole enumeration
+     * @return true if and only if the partitioning algorithm was successful
+     */
+
+    template <typename MatroidType, typename MatrixType, typename Candidates>
+    inline bool enumerate_candidates(MatroidType& matroid, MatrixType& matrix, matrix_permuted <const integer_matrix>& worker_matrix,
+        const Candidates& candidates, separation& separation, matroid_element_set& extra_elements, enumeration_progress& progress)
+    {
+      const size_t num_candidates = candidates.size();
+      std::atomic <size_t> next_candidate(0);
+      std::atomic <size_t> first_found(num_candidates);
+      separation_search_worker <Candidates> worker = { worker_matrix.data(), candidates, next_candidate, first_found, progress };
+      run_reserved_worker_threads(num_worker_threads(num_candidates), worker);
+
+      if (first_found.load() == num_candidates)
+        return false;
+
+      /// Repeat the successful partitioning on the real matroid.
+      std::vector <mapping_value_t> row_mapping(worker_matrix.size1(), 0);
+      std::vector <mapping_value_t> column_mapping(worker_matrix.size2(), 0);
+      candidates(first_found.load(), row_mapping, column_mapping);
+      size_pair_t top_left_size, bottom_right_size;
+      apply_mappings(worker_matrix, row_mapping, column_mapping, top_left_size, bottom_right_size);
+      bool extended = extend_to_3_4_separation(matroid, matrix, worker_matrix, top_left_size, bottom_right_size, separation, extra_elements);
+      assert(extended);
+      return extended;
     }
 
   }
@@ -604,8 +790,6 @@ namespace tu
   inline separation enumerate_separations(MatroidType& matroid, MatrixType& matrix, const NestedMinorSequence& nested_minors,
       matroid_element_set& extra_elements, logger& log)
   {
-    typedef signed char mapping_value_t;
-
     /// Every regular 3-connected matroid which is non-graphic, non-cographic and not isomorphic to R10 must contain R12
     if (matrix.size1() + matrix.size2() < 12)
     {
@@ -633,19 +817,15 @@ namespace tu
     const integer_matrix worker_matrix_base(matrix);
 
     matrix_permuted <const integer_matrix> worker_matrix(worker_matrix_base);
-    std::vector <mapping_value_t> row_mapping(worker_matrix_base.size1(), 0);
-    std::vector <mapping_value_t> column_mapping(worker_matrix_base.size2(), 0);
     separation result;
 
-    unsigned long long enumeration = 0;
-
     /// Calculate number of enumerations
     size_t cut = 0, full_cut = 0;
     unsigned long long max_enumerations = 0;
 
     if (log.is_progressive() || log.is_verbose())
     {
-      max_enumerations = 1L << (minor_size.first + minor_size.second);
+      max_enumerations = 1L << (minor_size.first + minor_size.second - 1);
       size_t h = minor_size.first;
       size_t w = minor_size.second;
       for (size_t i = minor_index; i < nested_minors.size(); ++i)
@@ -684,42 +864,13 @@ namespace tu
       }
     }
 
-    unsigned long long next_enumeration = max_enumerations / 100;
-    unsigned int next_percent = 1;
+    detail::enumeration_progress progress(log, cut, max_enumerations);
 
     /// Full enumeration
-    size_t limit = (1 << (minor_size.first + minor_size.second));
-    for (size_t bits = 0; bits < limit; ++bits)
+    if (detail::enumerate_candidates(matroid, matrix, worker_matrix, detail::full_enumeration_candidates(minor_size), result, extra_elements,
+        progress))
     {
-      ++enumeration;
-
-      for (size_t row = 0; row < minor_size.first; ++row)
-      {
-        row_mapping[row] = ((bits >> row) & 0x1) ? 1 : -1;
-      }
-      for (size_t column = 0; column < minor_size.second; ++column)
-      {
-        column_mapping[column] = ((bits >> (minor_size.first + column)) & 0x1) ? 1 : -1;
-      }
-
-      /// Transform the mappings into row/column permutations.
-      size_pair_t widths = detail::apply_mapping(worker_matrix.perm2(), column_mapping);
-      size_pair_t heights = detail::apply_mapping(worker_matrix.perm1(), row_mapping);
-
-      if (detail::extend_to_3_4_separation(matroid, matrix, worker_matrix, size_pair_t(heights.first, widths.first), size_pair_t(heights.second,
-          widths.second), result, extra_elements))
-      {
-        return result;
-      }
-
-      if (log.is_progressive() && enumeration == next_enumeration)
-      {
-        log.erase(cut);
-        log.line() << next_percent << '%';
-        std::cout << log;
-        next_percent++;
-        next_enumeration = (max_enumerations * next_percent) / 100;
-      }
+      return result;
     }
 
     if (log.is_verbose())
@@ -732,8 +883,8 @@ namespace tu
     {
       size_t extension_height = nested_minors.get_extension_height(i);
       size_t extension_width = nested_minors.get_extension_width(i);
-      if (detail::enumerate_extension(matroid, matrix, worker_matrix, row_mapping, column_mapping, minor_size, extension_height, extension_width,
-          result, extra_elements, enumeration, next_enumeration, max_enumerations, next_percent, log, cut))
+      if (detail::enumerate_candidates(matroid, matrix, worker_matrix, detail::extension_candidates(minor_size, extension_height,
+          extension_width), result, extra_elements, progress))
       {
         return result;
       }
@@ -749,7 +900,7 @@ namespace tu
     if (log.is_progressive())
     {
       log.erase(full_cut);
-      log.line() << ", ENUMERATED " << enumeration << " PARTITIONS --> IRREGULAR";
+      log.line() << ", ENUMERATED " << progress.enumeration.load() << " PARTITIONS --> IRREGULAR";
       std::cout << log << std::endl;
       log.clear();
     }
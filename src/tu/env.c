@@ -10,6 +10,11 @@
 #include <stdarg.h>
 #include <string.h>
 
+#if defined(TU_WITH_THREADS)
+#include <pthread.h>
+#include <stdatomic.h>
+#endif /* TU_WITH_THREADS */
+
 static const size_t FIRST_STACK_SIZE = 4096L; /**< Size of the first stack. */
 static const int INITIAL_MEM_STACKS = 16;     /**< Initial number of allocated stacks. */
 
@@ -17,35 +22,113 @@ static const int INITIAL_MEM_STACKS = 16;     /**< Initial number of allocated s
 static const int PROTECTION = INT_MIN / 42;   /**< Protection bytes to detect corruption. */
 #endif /* !NDEBUG */
 
-TU_ERROR TUcreateEnvironment(TU** ptu)
+#define MAX_STACK_LEVELS 48                      /**< Number of different stack sizes managed by the pool. */
+
+/**
+ * \brief Pool of stack memory shared by an environment and all environments created from it.
+ *
+ * For each size \c FIRST_STACK_SIZE << k it stores a list of unused stacks. The first bytes of an unused stack point
+ * to the next one.
+ */
+
+struct TU_STACKPOOL
 {
-  if (!ptu)
-    return TU_ERROR_INPUT;
+#if defined(TU_WITH_THREADS)
+  pthread_mutex_t mutex;                /**< \brief Protects the lists and the user count. */
+#endif /* TU_WITH_THREADS */
+  int numUsers;                         /**< \brief Number of environments using the pool. */
+  char* unused[MAX_STACK_LEVELS];       /**< \brief Lists of unused stacks, one for each size. */
+};
+
+static TU_ERROR freeThreadPool(TU* tu);
+
+/**
+ * \brief Takes a stack of size \c FIRST_STACK_SIZE << \p level from the pool or allocates it.
+ */
+
+static
+char* acquireStackMemory(
+  TU* tu,       /**< \ref TU environment. */
+  size_t level  /**< Level of the stack. */
+)
+{
+  struct TU_STACKPOOL* pool = tu->stackPool;
+  char* memory = NULL;
 
-  *ptu = (TU*) malloc(sizeof(TU));
-  TU* tu = *ptu;
-  if (!tu)
-    return TU_ERROR_MEMORY;
+  if (level < MAX_STACK_LEVELS)
+  {
+#if defined(TU_WITH_THREADS)
+    pthread_mutex_lock(&pool->mutex);
+#endif /* TU_WITH_THREADS */
+    memory = pool->unused[level];
+    if (memory)
+      pool->unused[level] = *((char**) memory);
+#if defined(TU_WITH_THREADS)
+    pthread_mutex_unlock(&pool->mutex);
+#endif /* TU_WITH_THREADS */
+  }
+
+  if (!memory)
+    memory = malloc((FIRST_STACK_SIZE << level) * sizeof(char));
+
+  return memory;
+}
+
+/**
+ * \brief Returns a stack of size \c FIRST_STACK_SIZE << \p level to the pool.
+ */
+
+static
+void releaseStackMemory(
+  TU* tu,       /**< \ref TU environment. */
+  size_t level, /**< Level of the stack. */
+  char* memory  /**< Memory of the stack. */
+)
+{
+  struct TU_STACKPOOL* pool = tu->stackPool;
+
+  if (level >= MAX_STACK_LEVELS)
+  {
+    free(memory);
+    return;
+  }
+
+#if defined(TU_WITH_THREADS)
+  pthread_mutex_lock(&pool->mutex);
+#endif /* TU_WITH_THREADS */
+  *((char**) memory) = pool->unused[level];
+  pool->unused[level] = memory;
+#if defined(TU_WITH_THREADS)
+  pthread_mutex_unlock(&pool->mutex);
+#endif /* TU_WITH_THREADS */
+}
 
+/**
+ * \brief Initializes a freshly allocated environment that uses the given stack pool.
+ */
+
+static
+TU_ERROR initEnvironment(
+  TU* tu,                     /**< \ref TU environment. */
+  struct TU_STACKPOOL* pool   /**< Stack pool to be used. */
+)
+{
   tu->output = stdout;
   tu->closeOutput = false;
   tu->numThreads = 1;
+  tu->threadPool = NULL;
+  tu->taskPool = NULL;
   tu->verbosity = 1;
+  tu->stackPool = pool;
 
   /* Initialize stack memory. */
   tu->stacks = malloc(INITIAL_MEM_STACKS * sizeof(TU_STACK));
   if (!tu->stacks)
-  {
-    free(*ptu);
-    *ptu = NULL;
     return TU_ERROR_MEMORY;
-  }
-  tu->stacks[0].memory = malloc(FIRST_STACK_SIZE * sizeof(char));
+  tu->stacks[0].memory = acquireStackMemory(tu, 0);
   if (!tu->stacks[0].memory)
   {
     free(tu->stacks);
-    free(tu);
-    *ptu = NULL;
     return TU_ERROR_MEMORY;
   }
   tu->stacks[0].top = FIRST_STACK_SIZE;
@@ -53,6 +136,79 @@ TU_ERROR TUcreateEnvironment(TU** ptu)
   tu->numStacks = 1;
   tu->currentStack = 0;
 
+#if defined(TU_WITH_THREADS)
+  pthread_mutex_lock(&pool->mutex);
+#endif /* TU_WITH_THREADS */
+  ++pool->numUsers;
+#if defined(TU_WITH_THREADS)
+  pthread_mutex_unlock(&pool->mutex);
+#endif /* TU_WITH_THREADS */
+
+  return TU_OKAY;
+}
+
+TU_ERROR TUcreateEnvironment(TU** ptu)
+{
+  if (!ptu)
+    return TU_ERROR_INPUT;
+
+  *ptu = (TU*) malloc(sizeof(TU));
+  TU* tu = *ptu;
+  if (!tu)
+    return TU_ERROR_MEMORY;
+
+  struct TU_STACKPOOL* pool = (struct TU_STACKPOOL*) malloc(sizeof(struct TU_STACKPOOL));
+  if (!pool)
+  {
+    free(tu);
+    *ptu = NULL;
+    return TU_ERROR_MEMORY;
+  }
+#if defined(TU_WITH_THREADS)
+  pthread_mutex_init(&pool->mutex, NULL);
+#endif /* TU_WITH_THREADS */
+  pool->numUsers = 0;
+  for (int level = 0; level < MAX_STACK_LEVELS; ++level)
+    pool->unused[level] = NULL;
+
+  tu->parent = NULL;
+  TU_ERROR error = initEnvironment(tu, pool);
+  if (error)
+  {
+#if defined(TU_WITH_THREADS)
+    pthread_mutex_destroy(&pool->mutex);
+#endif /* TU_WITH_THREADS */
+    free(pool);
+    free(tu);
+    *ptu = NULL;
+  }
+
+  return error;
+}
+
+TU_ERROR TUcreateThreadEnvironment(TU* tu, TU** pchild)
+{
+  assert(tu);
+
+  if (!pchild)
+    return TU_ERROR_INPUT;
+
+  *pchild = (TU*) malloc(sizeof(TU));
+  TU* child = *pchild;
+  if (!child)
+    return TU_ERROR_MEMORY;
+
+  child->parent = tu;
+  TU_ERROR error = initEnvironment(child, tu->stackPool);
+  if (error)
+  {
+    free(child);
+    *pchild = NULL;
+    return error;
+  }
+  child->output = tu->output;
+  child->verbosity = tu->verbosity;
+
   return TU_OKAY;
 }
 
@@ -66,15 +222,72 @@ TU_ERROR TUfreeEnvironment(TU** ptu)
   if (tu->closeOutput)
     fclose(tu->output);
 
-  for (int s = 0; s < tu->numStacks; ++s)
-    free(tu->stacks[s].memory);
+  TU_CALL( freeThreadPool(tu) );
+
+  /* Hand the stacks over to the pool. */
+  for (size_t s = 0; s < tu->numStacks; ++s)
+    releaseStackMemory(tu, s, tu->stacks[s].memory);
   free(tu->stacks);
+
+  struct TU_STACKPOOL* pool = tu->stackPool;
+#if defined(TU_WITH_THREADS)
+  pthread_mutex_lock(&pool->mutex);
+#endif /* TU_WITH_THREADS */
+  --pool->numUsers;
+#if defined(TU_WITH_THREADS)
+  pthread_mutex_unlock(&pool->mutex);
+#endif /* TU_WITH_THREADS */
+
+  if (!tu->parent)
+  {
+    /* Environments created by TUcreateThreadEnvironment must be freed before. */
+    assert(pool->numUsers == 0);
+
+    for (int level = 0; level < MAX_STACK_LEVELS; ++level)
+    {
+      while (pool->unused[level])
+      {
+        char* memory = pool->unused[level];
+        pool->unused[level] = *((char**) memory);
+        free(memory);
+      }
+    }
+#if defined(TU_WITH_THREADS)
+    pthread_mutex_destroy(&pool->mutex);
+#endif /* TU_WITH_THREADS */
+    free(pool);
+  }
+
   free(*ptu);
   *ptu = NULL;
 
   return TU_OKAY;
 }
 
+TU_ERROR TUsetNumThreads(TU* tu, int numThreads)
+{
+  assert(tu);
+
+  if (numThreads < 1)
+    return TU_ERROR_INPUT;
+
+  if (numThreads != tu->numThreads)
+  {
+    /* The pool is created again with the right number of workers when needed. */
+    TU_CALL( freeThreadPool(tu) );
+    tu->numThreads = numThreads;
+  }
+
+  return TU_OKAY;
+}
+
+int TUgetNumThreads(TU* tu)
+{
+  assert(tu);
+
+  return tu->numThreads;
+}
+
 TU_ERROR _TUallocBlock(TU* tu, void** ptr, size_t size)
 {
   assert(tu);
@@ -218,8 +431,11 @@ TU_ERROR _TUallocStack(
         tu->memStacks = newSize;
       }
 
+      /* Only this step may need a lock since the memory is taken from the shared pool. */
       tu->stacks[tu->numStacks].top = FIRST_STACK_SIZE << tu->numStacks;
-      tu->stacks[tu->numStacks].memory = malloc(tu->stacks[tu->numStacks].top * sizeof(char));
+      tu->stacks[tu->numStacks].memory = acquireStackMemory(tu, tu->numStacks);
+      if (!tu->stacks[tu->numStacks].memory)
+        return TU_ERROR_MEMORY;
       ++tu->numStacks;
     }
 
@@ -329,6 +545,283 @@ void TUassertStackConsistency(
 
 #endif /* else REPLACE_STACK_BY_MALLOC */
 
+#if defined(TU_WITH_THREADS)
+
+/**
+ * \brief Worker thread of a \ref TU_THREADPOOL.
+ */
+
+typedef struct
+{
+  pthread_t thread;             /**< \brief Thread handle. */
+  TU* tu;                       /**< \brief Environment of this thread, used for stack memory. */
+  struct TU_THREADPOOL* pool;   /**< \brief Pool this worker belongs to. */
+} TU_WORKER;
+
+/**
+ * \brief Pool of worker threads that waits for jobs passed via \ref TUrunTasks.
+ */
+
+struct TU_THREADPOOL
+{
+  int numWorkers;               /**< \brief Number of worker threads. */
+  TU_WORKER* workers;           /**< \brief Array of workers. */
+  pthread_mutex_t mutex;        /**< \brief Protects the job description and the counters below. */
+  pthread_cond_t wakeup;        /**< \brief Signaled if a new job is available or the pool shuts down. */
+  pthread_cond_t finished;      /**< \brief Signaled if a worker finished the current job. */
+  size_t generation;            /**< \brief Number of jobs started so far. */
+  int numBusy;                  /**< \brief Number of workers still working on the current job. */
+  bool shutdown;                /**< \brief Whether the workers shall terminate. */
+
+  TU_TASK_FUNCTION function;    /**< \brief Task function of the current job. */
+  void* data;                   /**< \brief Data of the current job. */
+  int numTasks;                 /**< \brief Number of tasks of the current job. */
+  atomic_int nextTask;          /**< \brief Next task to be started. */
+  atomic_bool cancelled;        /**< \brief Whether some task requested cancellation. */
+  TU_ERROR error;               /**< \brief First error returned by a task. */
+};
+
+/**
+ * \brief Carries out tasks of the current job of \p pool until none is left or cancellation was requested.
+ */
+
+static
+void runPoolTasks(
+  struct TU_THREADPOOL* pool, /**< Thread pool. */
+  TU* tu                      /**< \ref TU environment of the executing thread. */
+)
+{
+  while (!atomic_load(&pool->cancelled))
+  {
+    int task = atomic_fetch_add(&pool->nextTask, 1);
+    if (task >= pool->numTasks)
+      break;
+
+    bool cancel = false;
+    TU_ERROR error = pool->function(tu, task, pool->data, &cancel);
+    if (error)
+    {
+      pthread_mutex_lock(&pool->mutex);
+      if (!pool->error)
+        pool->error = error;
+      pthread_mutex_unlock(&pool->mutex);
+      cancel = true;
+    }
+    if (cancel)
+      atomic_store(&pool->cancelled, true);
+  }
+}
+
+/**
+ * \brief Main function of a worker thread.
+ */
+
+static
+void* workerMain(
+  void* arg /**< Pointer to the \ref TU_WORKER. */
+)
+{
+  TU_WORKER* worker = (TU_WORKER*) arg;
+  struct TU_THREADPOOL* pool = worker->pool;
+  size_t generation = 0;
+
+  pthread_mutex_lock(&pool->mutex);
+  while (true)
+  {
+    while (pool->generation == generation && !pool->shutdown)
+      pthread_cond_wait(&pool->wakeup, &pool->mutex);
+    if (pool->shutdown)
+      break;
+    generation = pool->generation;
+    pthread_mutex_unlock(&pool->mutex);
+
+    runPoolTasks(pool, worker->tu);
+
+    pthread_mutex_lock(&pool->mutex);
+    if (--pool->numBusy == 0)
+      pthread_cond_signal(&pool->finished);
+  }
+  pthread_mutex_unlock(&pool->mutex);
+
+  return NULL;
+}
+
+/**
+ * \brief Creates the thread pool of \p tu with \c numThreads - 1 workers.
+ */
+
+static
+TU_ERROR createThreadPool(
+  TU* tu  /**< \ref TU environment. */
+)
+{
+  assert(tu);
+  assert(!tu->threadPool);
+  assert(tu->numThreads > 1);
+
+  struct TU_THREADPOOL* pool = NULL;
+  TU_CALL( TUallocBlock(tu, &pool) );
+  pool->numWorkers = 0;
+  pool->workers = NULL;
+  TU_CALL( TUallocBlockArray(tu, &pool->workers, tu->numThreads - 1) );
+  pthread_mutex_init(&pool->mutex, NULL);
+  pthread_cond_init(&pool->wakeup, NULL);
+  pthread_cond_init(&pool->finished, NULL);
+  pool->generation = 0;
+  pool->numBusy = 0;
+  pool->shutdown = false;
+  pool->function = NULL;
+  pool->data = NULL;
+  pool->numTasks = 0;
+  atomic_init(&pool->nextTask, 0);
+  atomic_init(&pool->cancelled, false);
+  pool->error = TU_OKAY;
+  tu->threadPool = pool;
+
+  for (int w = 0; w < tu->numThreads - 1; ++w)
+  {
+    TU_WORKER* worker = &pool->workers[w];
+    worker->pool = pool;
+    worker->tu = NULL;
+    TU_CALL( TUcreateThreadEnvironment(tu, &worker->tu) );
+    worker->tu->taskPool = pool;
+    if (pthread_create(&worker->thread, NULL, workerMain, worker))
+    {
+      TU_CALL( TUfreeEnvironment(&worker->tu) );
+      return TU_ERROR_MEMORY;
+    }
+    ++pool->numWorkers;
+  }
+
+  return TU_OKAY;
+}
+
+/**
+ * \brief Terminates the workers of \p tu's thread pool and frees it.
+ */
+
+static
+TU_ERROR freeThreadPool(
+  TU* tu  /**< \ref TU environment. */
+)
+{
+  assert(tu);
+
+  struct TU_THREADPOOL* pool = tu->threadPool;
+  if (!pool)
+    return TU_OKAY;
+
+  pthread_mutex_lock(&pool->mutex);
+  pool->shutdown = true;
+  pthread_cond_broadcast(&pool->wakeup);
+  pthread_mutex_unlock(&pool->mutex);
+
+  for (int w = 0; w < pool->numWorkers; ++w)
+  {
+    pthread_join(pool->workers[w].thread, NULL);
+    TU_CALL( TUfreeEnvironment(&pool->workers[w].tu) );
+  }
+
+  pthread_cond_destroy(&pool->finished);
+  pthread_cond_destroy(&pool->wakeup);
+  pthread_mutex_destroy(&pool->mutex);
+  TU_CALL( TUfreeBlockArray(tu, &pool->workers) );
+  TU_CALL( TUfreeBlock(tu, &tu->threadPool) );
+
+  return TU_OKAY;
+}
+
+bool TUtasksCancelled(TU* tu)
+{
+  assert(tu);
+
+  return tu->taskPool && atomic_load(&tu->taskPool->cancelled);
+}
+
+TU_ERROR TUrunTasks(TU* tu, int numTasks, TU_TASK_FUNCTION function, void* data, bool* pcancelled)
+{
+  assert(tu);
+  assert(function);
+
+  if (tu->numThreads > 1 && numTasks > 1)
+  {
+    if (!tu->threadPool)
+      TU_CALL( createThreadPool(tu) );
+    struct TU_THREADPOOL* pool = tu->threadPool;
+
+    pthread_mutex_lock(&pool->mutex);
+    pool->function = function;
+    pool->data = data;
+    pool->numTasks = numTasks;
+    atomic_store(&pool->nextTask, 0);
+    atomic_store(&pool->cancelled, false);
+    pool->error = TU_OKAY;
+    pool->numBusy = pool->numWorkers;
+    ++pool->generation;
+    pthread_cond_broadcast(&pool->wakeup);
+    pthread_mutex_unlock(&pool->mutex);
+
+    tu->taskPool = pool;
+    runPoolTasks(pool, tu);
+    tu->taskPool = NULL;
+
+    pthread_mutex_lock(&pool->mutex);
+    while (pool->numBusy > 0)
+      pthread_cond_wait(&pool->finished, &pool->mutex);
+    TU_ERROR error = pool->error;
+    pthread_mutex_unlock(&pool->mutex);
+
+    if (pcancelled)
+      *pcancelled = atomic_load(&pool->cancelled);
+
+    return error;
+  }
+
+  bool cancel = false;
+  for (int task = 0; task < numTasks && !cancel; ++task)
+    TU_CALL( function(tu, task, data, &cancel) );
+  if (pcancelled)
+    *pcancelled = cancel;
+
+  return TU_OKAY;
+}
+
+#else /* TU_WITH_THREADS */
+
+bool TUtasksCancelled(TU* tu)
+{
+  assert(tu);
+
+  return false;
+}
+
+static
+TU_ERROR freeThreadPool(
+  TU* tu  /**< \ref TU environment. */
+)
+{
+  assert(tu);
+  assert(!tu->threadPool);
+
+  return TU_OKAY;
+}
+
+TU_ERROR TUrunTasks(TU* tu, int numTasks, TU_TASK_FUNCTION function, void* data, bool* pcancelled)
+{
+  assert(tu);
+  assert(function);
+
+  bool cancel = false;
+  for (int task = 0; task < numTasks && !cancel; ++task)
+    TU_CALL( function(tu, task, data, &cancel) );
+  if (pcancelled)
+    *pcancelled = cancel;
+
+  return TU_OKAY;
+}
+
+#endif /* TU_WITH_THREADS */
+
 char* TUconsistencyMessage(const char* format, ...)
 {
   assert(format);
@@ -33,17 +33,24 @@ typedef struct
   size_t top;   /**< \brief First used byte. */
 } TU_STACK;
 
+struct TU_THREADPOOL;
+struct TU_STACKPOOL;
+
 struct TU_ENVIRONMENT
 {
   FILE* output;         /**< \brief Output stream or \c NULL if silent. */
   bool closeOutput;     /**< \brief Whether to close the output stream at the end. */
   int verbosity;        /**< \brief Verbosity level. */
   int numThreads;       /**< \brief Number of threads to use. */
+  struct TU_THREADPOOL* threadPool; /**< \brief Worker threads or \c NULL if not (yet) created. */
+  struct TU_THREADPOOL* taskPool; /**< \brief Pool whose tasks this environment currently runs, or \c NULL. */
+  struct TU_ENVIRONMENT* parent; /**< \brief Environment this one was created from, or \c NULL. */
+  struct TU_STACKPOOL* stackPool; /**< \brief Unused stacks, shared with the parent and its other children. */
 
   size_t numStacks;     /**< \brief Number of allocated stacks in stack array. */
   size_t memStacks;     /**< \brief Memory for stack array. */
   size_t currentStack;  /**< \brief Index of last used stack. */
-  TU_STACK* stacks;     /**< \brief Array of stacks. */
+  TU_STACK* stacks;     /**< \brief Array of stacks; stack \c k has size \c FIRST_STACK_SIZE << k. */
 };
 
 #include <tu/env.h>
@@ -129,6 +136,50 @@ void TUassertStackConsistency(
 
 #endif /* !NDEBUG */
 
+/**
+ * \brief Function that carries out a single task of \ref TUrunTasks.
+ *
+ * It is called with the \ref TU environment of the executing thread, which must be used for all stack memory. If it
+ * sets *\p pcancel to \c true, then no further tasks are started.
+ */
+
+typedef TU_ERROR (*TU_TASK_FUNCTION)(
+  TU* tu,       /**< \ref TU environment of the executing thread. */
+  int task,     /**< Index of the task. */
+  void* data,   /**< Data shared by all tasks. */
+  bool* pcancel /**< Pointer for requesting cancellation of all remaining tasks. */
+);
+
+/**
+ * \brief Returns whether some task of the \ref TUrunTasks call that \p tu currently works on requested cancellation.
+ *
+ * Long-running tasks shall check this regularly and return early if it holds, since their results are then ignored.
+ * Outside of tasks and for sequentially run tasks, it always returns \c false.
+ */
+
+bool TUtasksCancelled(
+  TU* tu  /**< \ref TU environment of the executing thread. */
+);
+
+/**
+ * \brief Runs tasks 0, 1, ..., \p numTasks - 1 on the environment's worker threads.
+ *
+ * Tasks are started in increasing order of their indices. The calling thread participates and the function returns
+ * when all started tasks are finished. Each worker thread has its own \ref TU environment for stack memory, and the
+ * calling thread uses \p tu. The worker environments are created by \ref TUcreateThreadEnvironment. If the library
+ * is built without threads or only one thread shall be used, the tasks are run sequentially.
+ *
+ * If \p pcancelled is not \c NULL, *\p pcancelled indicates whether some task requested cancellation.
+ */
+
+TU_ERROR TUrunTasks(
+  TU* tu,                     /**< \ref TU environment. */
+  int numTasks,               /**< Number of tasks. */
+  TU_TASK_FUNCTION function,  /**< Function that carries out a task. */
+  void* data,                 /**< Data passed to each call of \p function. */
+  bool* pcancelled            /**< Pointer for storing whether some task requested cancellation (may be \c NULL). */
+);
+
 char* TUconsistencyMessage(const char* format, ...);
 
 #if !defined(NDEBUG)
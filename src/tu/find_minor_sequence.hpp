@@ -8,6 +8,7 @@
 #include "matrix_modified.hpp"
 #include "bipartite_graph_bfs.hpp"
 #include "comparators.hpp"
+#include "graphicness.hpp"
 #include "logger.hpp"
 
 namespace tu
@@ -22,30 +23,95 @@ namespace tu
    * @param nested_minors Sequence of nested minors
    * @param row_three_connectivity Connectivities of all possible rows
    * @param column_three_connectivity Connectivities of all possible columns
+   * @param preference Functor telling whether a row is preferred, and whether to ask it at all
    * @return true if and only if the extension was found
    */
 
   template <typename MatroidType, typename MatrixType, typename NestedMinorSequenceType, typename RowThreeConnectivity,
-      typename ColumnThreeConnectivity>
+      typename ColumnThreeConnectivity, typename Preference>
   bool find_simple_row_extension(MatroidType& matroid, MatrixType& matrix, NestedMinorSequenceType& nested_minors,
-      RowThreeConnectivity& row_three_connectivity, ColumnThreeConnectivity& column_three_connectivity)
+      RowThreeConnectivity& row_three_connectivity, ColumnThreeConnectivity& column_three_connectivity,
+      Preference& preference)
   {
+    size_t chosen_row = matroid.size1();
     for (size_t row = nested_minors.height(); row < matroid.size1(); ++row)
     {
       if (row_three_connectivity.is_other(row))
       {
-        matroid_permute1(matroid, matrix, nested_minors.height(), row);
-        row_three_connectivity.swap_vectors(nested_minors.height(), row);
-        nested_minors.push(nested_minor_sequence::ONE_ROW);
-        row_three_connectivity.enlarge_base();
-        column_three_connectivity.enlarge_dimension();
-        return true;
+        if (chosen_row == matroid.size1())
+          chosen_row = row;
+        if (!preference.is_active())
+          break;
+        if (preference(row))
+        {
+          chosen_row = row;
+          break;
+        }
       }
     }
 
-    return false;
+    if (chosen_row == matroid.size1())
+      return false;
+
+    matroid_permute1(matroid, matrix, nested_minors.height(), chosen_row);
+    row_three_connectivity.swap_vectors(nested_minors.height(), chosen_row);
+    nested_minors.push(nested_minor_sequence::ONE_ROW);
+    row_three_connectivity.enlarge_base();
+    column_three_connectivity.enlarge_dimension();
+    return true;
   }
 
+  /**
+   * Prefers simple extensions that make the largest minor non-graphic or non-cographic, following the heuristic
+   * that the sequence should become neither graphic nor cographic as early as possible. For a row, only the cheap
+   * check for cographicness is done, and for a column, only the one for graphicness. The number of checks per
+   * extension is limited since each takes time linear in the nonzeros of the candidate.
+   */
+
+  template <typename MatrixType>
+  struct non_graphic_extension_preference
+  {
+    static const size_t max_checks = 8;
+
+    non_graphic_extension_preference(detail::nested_minor_graphicness& graphicness, MatrixType& matrix,
+        bool columns) :
+      _graphicness(graphicness), _matrix(matrix), _columns(columns), _num_checks(0)
+    {
+
+    }
+
+    /**
+     * Prepares the preference for the next extension.
+     */
+
+    void reset()
+    {
+      _num_checks = 0;
+    }
+
+    bool is_active() const
+    {
+      if (_num_checks >= max_checks)
+        return false;
+      return _columns ? _graphicness.is_graphic() : _graphicness.is_cographic();
+    }
+
+    bool operator()(size_t index)
+    {
+      ++_num_checks;
+      if (_columns)
+        return _graphicness.column_breaks_graphicness(_matrix, index);
+      else
+        return _graphicness.row_breaks_cographicness(_matrix, index);
+    }
+
+  private:
+    detail::nested_minor_graphicness& _graphicness;
+    MatrixType& _matrix;
+    bool _columns;
+    size_t _num_checks;
+  };
+
   /**
    * Takes a represented matroid and a sequence of nested minors and
    * searches for a row (resp. column) below (right to) the last minor
@@ -393,16 +459,22 @@ namespace tu
    * @param matrix Representation matrix for the given matroid
    * @param nested_minors Sequence of nested minors
    * @param extra_elements Set of matroid-elements to be filled with pivot elements
+   * @param graphicness Returns the largest graphic and cographic minors of the sequence
    * @param log Logger
    * @return Either a 2-separation or no separation, in case the matroid is 3-connected.
    */
 
   template <typename MatroidType, typename MatrixType>
   separation find_minor_sequence(MatroidType& matroid, MatrixType& matrix, nested_minor_sequence& nested_minors, matroid_element_set& extra_elements,
-      logger& log)
+      detail::nested_minor_graphicness& graphicness, logger& log)
   {
     size_t cut = log.size();
-    
+
+    /// The sequence may already be nontrivial if we continue after a 2-separation.
+    graphicness.update(matrix, nested_minors);
+    non_graphic_extension_preference <MatrixType> row_preference(graphicness, matrix, false);
+    non_graphic_extension_preference <MatrixType> column_preference(graphicness, matrix, true);
+
     matroid_transposed <MatroidType> transposed_matroid(matroid);
     matrix_transposed <MatrixType> transposed_matrix(matrix);
 
@@ -428,19 +500,25 @@ namespace tu
       assert (nested_minors.width() == column_three_connectivity.base());
 
       /// Simple row extension
-      if (find_simple_row_extension(matroid, matrix, nested_minors, row_three_connectivity, column_three_connectivity))
+      row_preference.reset();
+      if (find_simple_row_extension(matroid, matrix, nested_minors, row_three_connectivity, column_three_connectivity,
+          row_preference))
       {
+        graphicness.extend(matrix, nested_minors);
         continue;
       }
 
       /// Simple column extension
+      column_preference.reset();
       if (find_simple_row_extension(transposed_matroid, transposed_matrix, transposed_nested_minors, column_three_connectivity,
-          row_three_connectivity))
+          row_three_connectivity, column_preference))
       {
+        graphicness.extend(matrix, nested_minors);
         continue;
       }
 
       size_t the_index = 0;
+      size_t num_extensions = nested_minors.size();
       char type = find_parallel_or_unit_vector(matroid, matrix, nested_minors, row_three_connectivity, column_three_connectivity, the_index);
       if (type == 0)
       {
@@ -469,6 +547,10 @@ namespace tu
         throw std::runtime_error("tu::find_minor_sequence: Invalid parallel/unit-vector type.");
       }
 
+      /// Elaborate extensions only pivot on rows and columns that are zero on the largest minor, so it stays intact.
+      if (nested_minors.size() > num_extensions)
+        graphicness.extend(matrix, nested_minors);
+
       row_three_connectivity.reset(nested_minors.width(), nested_minors.height());
       column_three_connectivity.reset(nested_minors.height(), nested_minors.width());
     }
@@ -480,6 +562,7 @@ namespace tu
       std::cout << log;
     }
 
+    graphicness.complete(matrix, nested_minors);
     return separation();
   }
 
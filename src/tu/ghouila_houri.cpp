@@ -1,12 +1,23 @@
+#include <atomic>
+#include <cstdlib>
+#include <utility>
 #include <vector>
 
 #include <tu/total_unimodularity.hpp>
+#include "parallel.hpp"
 
 namespace tu
 {
 
   /**
-   * Class to enumerate subset-2-partitions for a ghouila-houri test
+   * Class to enumerate subset-2-partitions for a ghouila-houri test. The row subsets are walked in Gray-code order,
+   * such that each step adds or removes a single row. The partition of the previous subset is kept and its column
+   * sums are updated by that row. Only if this yields no valid partition, the partitions of the subset are enumerated
+   * by a depth-first search, which discards a partial partition as soon as some column sum can no longer be brought
+   * into [-1,+1] by the remaining rows of the subset.
+   *
+   * The subsets can be restricted to those with a fixed choice of the last rows, such that several enumerators can
+   * share the work.
    */
 
   class ghouila_houri_enumerator
@@ -15,112 +26,285 @@ namespace tu
 
     typedef signed char choice_type;
     typedef std::vector <choice_type> choice_vector_type;
+    typedef std::vector <std::pair <size_t, int> > sparse_row_type;
 
     /**
      * Constructs an enumerator.
      *
+     * @param rows The nonzero rows of the matrix to be tested, see make_rows
+     * @param num_columns Number of columns of the matrix
+     */
+
+    ghouila_houri_enumerator(const std::vector <sparse_row_type>& rows, size_t num_columns) :
+      _rows(rows), _choice(rows.size(), 0), _partition_sums(num_columns, 0), _violations(0), _sums(num_columns, 0),
+          _slacks(num_columns, 0)
+    {
+
+    }
+
+    /**
+     * Stores the nonzero rows of a matrix sparsely.
+     *
      * @param matrix The matrix to be tested
+     * @param rows Returns the nonzero rows
      */
 
-    ghouila_houri_enumerator(const integer_matrix& matrix) :
-      _matrix(matrix)
+    static void make_rows(const integer_matrix& matrix, std::vector <sparse_row_type>& rows)
     {
-      _choice.resize(_matrix.size1());
-      for (choice_vector_type::iterator iter = _choice.begin(); iter != _choice.end(); ++iter)
+      for (size_t row = 0; row < matrix.size1(); ++row)
       {
-        *iter = 0;
+        sparse_row_type entries;
+        for (size_t column = 0; column < matrix.size2(); ++column)
+        {
+          if (matrix(row, column) != 0)
+            entries.push_back(std::make_pair(column, int(matrix(row, column))));
+        }
+
+        /// Zero rows do not change any sum and would only double the number of subsets.
+        if (!entries.empty())
+          rows.push_back(entries);
       }
     }
 
     /**
-     * Tests a sum induced by a 2-partition of the selected rows
+     * Adds a multiple of a row to the column sums of the current partition.
      *
-     * @return true if and only if the sum along each column is valid
+     * @param row The given row
+     * @param factor The multiple
      */
 
-    bool check_sum()
+    void add_to_partition(size_t row, int factor)
     {
-      for (size_t column = 0; column < _matrix.size2(); ++column)
+      for (sparse_row_type::const_iterator iter = _rows[row].begin(); iter != _rows[row].end(); ++iter)
       {
-        int sum = 0;
-        for (size_t row = 0; row < _matrix.size1(); ++row)
-        {
-          sum += _choice[row] * _matrix(row, column);
-        }
-        if (sum < -1 || sum > +1)
-          return false;
+        int& sum = _partition_sums[iter->first];
+        _violations -= (sum < -1 || sum > +1) ? 1 : 0;
+        sum += factor * iter->second;
+        _violations += (sum < -1 || sum > +1) ? 1 : 0;
       }
-      return true;
     }
 
     /**
-     * Recursively enumerates both possible choices for a given row.
+     * Adds a row to the selected subset or removes it from it. A new row is put into the part that keeps the
+     * partition valid, if possible. The slack of each column, i.e., the sum of absolute values of its selected
+     * entries, is updated accordingly.
      *
      * @param row The given row
-     * @return true if and only if one of the enumerations succeeded
      */
 
-    bool choose_partition(size_t row = 0)
+    void toggle_row(size_t row)
     {
-      while (row < _choice.size())
+      const int direction = _choice[row] ? -1 : +1;
+      for (sparse_row_type::const_iterator iter = _rows[row].begin(); iter != _rows[row].end(); ++iter)
+        _slacks[iter->first] += direction * std::abs(iter->second);
+
+      if (_choice[row])
+      {
+        add_to_partition(row, -_choice[row]);
+        _choice[row] = 0;
+      }
+      else
       {
-        if (_choice[row])
+        _choice[row] = 1;
+        add_to_partition(row, 1);
+        if (_violations > 0)
         {
           _choice[row] = -1;
-          if (choose_partition(row + 1))
-            return true;
-          _choice[row] = 1;
-          if (choose_partition(row + 1))
-            return true;
-          return false;
+          add_to_partition(row, -2);
         }
-        else
-          ++row;
       }
-      return check_sum();
     }
 
     /**
-     * Recursively enumerates all subset-choices for a given row.
-     * Finally it starts the enumeration of all the partitions of this subset.
+     * Assigns a selected row to one part of the partition in the depth-first search.
      *
      * @param row The given row
-     * @return true if and only if the further enumerations succeeded all.
+     * @param sign +1 or -1, depending on the part
+     * @return true if and only if each column sum can still be brought into [-1,+1]
      */
 
-    bool choose_subset(size_t row = 0)
+    bool assign_row(size_t row, int sign)
     {
-      if (row < _choice.size())
+      bool feasible = true;
+      for (sparse_row_type::const_iterator iter = _rows[row].begin(); iter != _rows[row].end(); ++iter)
       {
-        _choice[row] = 0;
-        if (!choose_subset(row + 1))
-          return false;
-        _choice[row] = 1;
-        if (!choose_subset(row + 1))
-          return false;
+        int& sum = _sums[iter->first];
+        int& slack = _slacks[iter->first];
+        sum += sign * iter->second;
+        slack -= std::abs(iter->second);
+        if (std::abs(sum) > slack + 1)
+          feasible = false;
+      }
+      return feasible;
+    }
+
+    /**
+     * Reverts assign_row.
+     *
+     * @param row The given row
+     * @param sign The sign given to assign_row
+     */
+
+    void unassign_row(size_t row, int sign)
+    {
+      for (sparse_row_type::const_iterator iter = _rows[row].begin(); iter != _rows[row].end(); ++iter)
+      {
+        _sums[iter->first] -= sign * iter->second;
+        _slacks[iter->first] += std::abs(iter->second);
+      }
+    }
+
+    /**
+     * Recursively enumerates both possible choices for the selected rows, starting at a given one. If a valid
+     * partition is found, it becomes the current partition.
+     *
+     * @param index Index of the given row among the selected ones
+     * @return true if and only if one of the enumerations succeeded
+     */
+
+    bool choose_partition(size_t index = 0)
+    {
+      if (index == _subset.size())
+      {
+        for (size_t i = 0; i < _subset.size(); ++i)
+          _choice[_subset[i]] = _signs[i];
+        _partition_sums = _sums;
+        _violations = 0;
         return true;
       }
 
+      /// The part of the row in the current partition is tried first.
+      const size_t row = _subset[index];
+      const choice_type sign = _choice[row];
+      _signs[index] = sign;
+      bool result = assign_row(row, sign) && choose_partition(index + 1);
+      unassign_row(row, sign);
+
+      /// Negating a valid partition yields a valid partition, so the first row keeps its part.
+      if (result || index == 0)
+        return result;
+
+      _signs[index] = -sign;
+      result = assign_row(row, -sign) && choose_partition(index + 1);
+      unassign_row(row, -sign);
+      return result;
+    }
+
+    /**
+     * Ensures that the current partition of the selected rows is valid, enumerating the partitions if necessary.
+     *
+     * @return true if and only if the selected rows have a valid partition
+     */
+
+    bool partition_subset()
+    {
+      if (_violations == 0)
+        return true;
+
+      _subset.clear();
+      for (size_t r = 0; r < _choice.size(); ++r)
+      {
+        if (_choice[r])
+          _subset.push_back(r);
+      }
+      _signs.resize(_subset.size());
+
       return choose_partition();
     }
 
     /**
-     * Tests the given matrix for total unimodularity using rows.
+     * Enumerates all subsets of the first rows in Gray-code order, together with the already selected other rows,
+     * and ensures a valid partition of each of them.
+     *
+     * @param num_free Number of first rows to be enumerated
+     * @param cancelled If not NULL, the enumeration stops with a positive result once this flag is set
+     * @return true if and only if the further enumerations succeeded all.
+     */
+
+    bool choose_subset(size_t num_free, std::atomic <bool>* cancelled)
+    {
+      if (!partition_subset())
+        return false;
+
+      /// The lowest bit changed by incrementing the counter is the row to be toggled.
+      std::vector <char> counter(num_free, 0);
+      while (!cancelled || !*cancelled)
+      {
+        size_t row = 0;
+        while (row < counter.size() && counter[row])
+          counter[row++] = 0;
+        if (row == counter.size())
+          return true;
+        counter[row] = 1;
+        toggle_row(row);
+
+        if (!partition_subset())
+          return false;
+      }
+      return true;
+    }
+
+    /**
+     * Tests the given matrix for total unimodularity using the subsets of rows which contain exactly those of the
+     * last num_fixed rows that are given by the bits of prefix.
      *
+     * @param num_fixed Number of last rows whose choice is fixed
+     * @param prefix Bit mask of the selected fixed rows
+     * @param cancelled If not NULL, the enumeration stops with a positive result once this flag is set
      * @return true if and only if it is totally unimodular
      */
 
-    inline bool check()
+    inline bool check(size_t num_fixed = 0, size_t prefix = 0, std::atomic <bool>* cancelled = NULL)
     {
-      return choose_subset();
+      const size_t num_free = _rows.size() - num_fixed;
+      for (size_t i = 0; i < num_fixed; ++i)
+      {
+        if (prefix & (size_t(1) << i))
+          toggle_row(num_free + i);
+      }
+      return choose_subset(num_free, cancelled);
     }
 
   private:
 
+    const std::vector <sparse_row_type>& _rows;
     choice_vector_type _choice;
-    const integer_matrix& _matrix;
+    std::vector <int> _partition_sums;
+    size_t _violations;
+    std::vector <size_t> _subset;
+    choice_vector_type _signs;
+    std::vector <int> _sums;
+    std::vector <int> _slacks;
   };
 
+  namespace detail
+  {
+
+    /**
+     * Enumerates the row subsets of one choice of the fixed rows (task) with its own enumerator. A subset without a
+     * valid partition sets failed, which stops all other tasks.
+     */
+
+    struct ghouila_houri_task
+    {
+      const std::vector <ghouila_houri_enumerator::sparse_row_type>& rows;
+      size_t num_columns;
+      size_t num_fixed;
+      std::atomic <bool>& failed;
+
+      void operator()(size_t task) const
+      {
+        if (failed)
+          return;
+
+        ghouila_houri_enumerator enumerator(rows, num_columns);
+        if (!enumerator.check(num_fixed, task, &failed))
+          failed = true;
+      }
+    };
+
+  } /* namespace detail */
+
   /**
    * Tests a given matrix to be totally unimodular using ghouila-houri's criterion by enumeration of row subsets.
    *
@@ -130,8 +314,19 @@ namespace tu
 
   bool ghouila_houri_is_totally_unimodular_enum_rows(const integer_matrix& matrix)
   {
-    ghouila_houri_enumerator enumerator(matrix);
-    return enumerator.check();
+    std::vector <ghouila_houri_enumerator::sparse_row_type> rows;
+    ghouila_houri_enumerator::make_rows(matrix, rows);
+
+    /// Split into several tasks per thread, since their running times differ a lot.
+    size_t num_fixed = 0;
+    const size_t num_threads = detail::available_threads();
+    while (num_threads > 1 && (size_t(1) << num_fixed) < 4 * num_threads && 2 * (num_fixed + 1) <= rows.size())
+      ++num_fixed;
+
+    std::atomic <bool> failed(false);
+    detail::ghouila_houri_task task = { rows, matrix.size2(), num_fixed, failed };
+    detail::run_tasks(size_t(1) << num_fixed, task);
+    return !failed;
   }
 
   /**
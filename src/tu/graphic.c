@@ -8,8 +8,6 @@
 #include "env_internal.h"
 #include "matrix_internal.h"
 #include "one_sum.h"
-#include "heap.h"
-#include "sort.h"
 
 #include <assert.h>
 #include <limits.h>
@@ -34,30 +32,30 @@ typedef enum
 } DIJKSTRA_STAGE;
 
 /**
- * \brief Node information for shortest-path computation in \ref TUcomputeGraphBinaryRepresentationMatrix.
+ * \brief Node information for the spanning forest computation in \ref TUcomputeGraphBinaryRepresentationMatrix.
  */
 
 typedef struct
 {
-  DIJKSTRA_STAGE stage;   /**< \brief At which stage of the algorithm is this node? */
-  int predecessor;        /**< \brief Predecessor node in shortest-path branching, or -1 for a root. */
-  TU_GRAPH_EDGE rootEdge; /**< \brief The actual edge towards the predecessor, or -1 for a root./ */
-  bool reversed;          /**< \brief Whether the edge towards the predecessor is reversed. */
-} DijkstraNodeData;
-
-/**
- * \brief Comparator for sorting ints using \ref TUsort2 in ascending way.
- */
-
-int compareInt2(const void** A, const void** B)
-{
-  int** a = (int**) A;
-  int** b = (int**) B;
-  return **a - **b;
-}
+  DIJKSTRA_STAGE stage;       /**< \brief At which stage of the algorithm is this node? */
+  int predecessor;            /**< \brief Predecessor node in shortest-path branching, or -1 for a root. */
+  TU_GRAPH_EDGE rootEdge;     /**< \brief The actual edge towards the predecessor, or -1 for a root./ */
+  bool reversed;              /**< \brief Whether the edge towards the predecessor is reversed. */
+  int distance;               /**< \brief Number of non-forest edges on the path from the root. */
+  int depth;                  /**< \brief Number of edges on the path from the root. */
+  int order;                  /**< \brief Index of the node in depth-first order of the branching. */
+  TU_GRAPH_NODE firstChild;   /**< \brief First child in the branching, or -1. */
+  TU_GRAPH_NODE nextSibling;  /**< \brief Next child of the predecessor in the branching, or -1. */
+} ForestNodeData;
 
 /**
  * \brief Computes the transpose of the binary or ternary representation matrix of a graph.
+ *
+ * The spanning forest is a shortest-path branching with respect to lengths 0 for given forest edges and 1 for all
+ * other edges, which is computed by a breadth-first search with a double-ended queue. The fundamental cycle of each
+ * other edge is obtained by walking from both end nodes up to their lowest common ancestor. Since nodes on these
+ * paths appear in depth-first order of the branching, merging both paths yields sorted columns, provided that the rows
+ * are numbered in this order, too. Otherwise, all columns are sorted at once at the end.
  */
 
 static
@@ -84,16 +82,16 @@ TU_ERROR computeRepresentationMatrix(
 
   TUdbgMsg(0, "Computing %s representation matrix.\n", ternary ? "ternary" : "binary");
 
-  DijkstraNodeData* nodeData = NULL;
-  TU_CALL( TUallocStackArray(tu, &nodeData, TUgraphMemNodes(graph)) );
-  TU_INTHEAP heap;
-  TU_CALL( TUintheapInitStack(tu, &heap, TUgraphMemNodes(graph)) );
-  int* lengths = NULL;
+  int memNodes = TUgraphMemNodes(graph);
+  ForestNodeData* nodeData = NULL;
+  TU_CALL( TUallocStackArray(tu, &nodeData, memNodes) );
+  char* lengths = NULL;
   TU_CALL( TUallocStackArray(tu, &lengths, TUgraphMemEdges(graph)) );
   for (TU_GRAPH_NODE v = TUgraphNodesFirst(graph); TUgraphNodesValid(graph, v);
     v = TUgraphNodesNext(graph, v))
   {
     nodeData[v].stage = UNKNOWN;
+    nodeData[v].firstChild = -1;
   }
   for (TU_GRAPH_ITER i = TUgraphEdgesFirst(graph); TUgraphEdgesValid(graph, i);
     i = TUgraphEdgesNext(graph, i))
@@ -113,7 +111,11 @@ TU_ERROR computeRepresentationMatrix(
 
   TUassertStackConsistency(tu);
 
-  /* Start Dijkstra's algorithm at each node. */
+  /* Start a breadth-first search at each node. Nodes reached via forest edges are put at the front of the queue. Each
+   * node is inserted at most twice, so twice the number of nodes suffices for the cyclic queue. */
+  int queueSize = 2 * memNodes + 1;
+  TU_GRAPH_NODE* queue = NULL;
+  TU_CALL( TUallocStackArray(tu, &queue, queueSize) );
   int countComponents = 0;
   for (TU_GRAPH_NODE s = TUgraphNodesFirst(graph); TUgraphNodesValid(graph, s);
     s = TUgraphNodesNext(graph, s))
@@ -121,15 +123,24 @@ TU_ERROR computeRepresentationMatrix(
     if (nodeData[s].stage != UNKNOWN)
       continue;
 
-    TUdbgMsg(2, "Executing Dijkstra at starting node %d.\n", s);
+    TUdbgMsg(2, "Executing breadth-first search at starting node %d.\n", s);
+    nodeData[s].stage = SEEN;
     nodeData[s].predecessor = -1;
     nodeData[s].rootEdge = -1;
+    nodeData[s].distance = 0;
     ++countComponents;
-    TUintheapInsert(&heap, s, 0);
-    while (!TUintheapEmpty(&heap))
+    int queueFirst = 0;
+    int queueLength = 1;
+    queue[0] = s;
+    while (queueLength > 0)
     {
-      int distance = TUintheapMinimumValue(&heap);
-      TU_GRAPH_NODE v = TUintheapExtractMinimum(&heap);
+      TU_GRAPH_NODE v = queue[queueFirst];
+      queueFirst = (queueFirst + 1) % queueSize;
+      --queueLength;
+      if (nodeData[v].stage == COMPLETED)
+        continue;
+
+      int distance = nodeData[v].distance;
       TUdbgMsg(4, "Processing node %d at distance %d.\n", v, distance);
       nodeData[v].stage = COMPLETED;
       for (TU_GRAPH_ITER i = TUgraphIncFirst(graph, v); TUgraphIncValid(graph, i);
@@ -144,32 +155,74 @@ TU_ERROR computeRepresentationMatrix(
 
         TU_GRAPH_EDGE e = TUgraphIncEdge(graph, i);
         int newDistance = distance + lengths[e];
-        if (newDistance < TUintheapGetValueInfinity(&heap, w))
+        if (nodeData[w].stage == UNKNOWN || newDistance < nodeData[w].distance)
         {
-          TUdbgMsg(6, "Updating distance of (%d,%d) from %d to %d.\n", v, w, TUintheapGetValueInfinity(&heap, w),
-            newDistance);
+          TUdbgMsg(6, "Updating distance of (%d,%d) to %d.\n", v, w, newDistance);
           nodeData[w].stage = SEEN;
+          nodeData[w].distance = newDistance;
           nodeData[w].predecessor = v;
           nodeData[w].rootEdge = e;
           nodeData[w].reversed = edgesReversed ? edgesReversed[e] : false;
           if (w == TUgraphEdgeU(graph, e))
             nodeData[w].reversed = !nodeData[w].reversed;
-          TUintheapDecreaseInsert(&heap, w, newDistance);
+          assert(queueLength < queueSize);
+          if (lengths[e] == 0)
+          {
+            queueFirst = (queueFirst + queueSize - 1) % queueSize;
+            queue[queueFirst] = w;
+          }
+          else
+            queue[(queueFirst + queueLength) % queueSize] = w;
+          ++queueLength;
         }
       }
     }
   }
 
   TUassertStackConsistency(tu);
-  TU_CALL( TUfreeStackArray(tu, &lengths) );
-  TU_CALL( TUintheapClearStack(tu, &heap) );
 
-  /* Now nodeData[.].predecessor is an arborescence for each connected component. */
+  /* Now nodeData[.].predecessor is an arborescence for each connected component. We compute depths and a depth-first
+   * order, reusing the queue as a stack. */
+
+  for (TU_GRAPH_NODE v = TUgraphNodesFirst(graph); TUgraphNodesValid(graph, v); v = TUgraphNodesNext(graph, v))
+  {
+    TU_GRAPH_NODE p = nodeData[v].predecessor;
+    if (p >= 0)
+    {
+      nodeData[v].nextSibling = nodeData[p].firstChild;
+      nodeData[p].firstChild = v;
+    }
+  }
+  TU_GRAPH_NODE* orderedNodes = NULL;
+  TU_CALL( TUallocStackArray(tu, &orderedNodes, TUgraphNumNodes(graph)) );
+  int numOrderedNodes = 0;
+  for (TU_GRAPH_NODE s = TUgraphNodesFirst(graph); TUgraphNodesValid(graph, s); s = TUgraphNodesNext(graph, s))
+  {
+    if (nodeData[s].predecessor >= 0)
+      continue;
+
+    nodeData[s].depth = 0;
+    int stackSize = 1;
+    queue[0] = s;
+    while (stackSize > 0)
+    {
+      TU_GRAPH_NODE v = queue[--stackSize];
+      nodeData[v].order = numOrderedNodes;
+      orderedNodes[numOrderedNodes++] = v;
+      for (TU_GRAPH_NODE w = nodeData[v].firstChild; w >= 0; w = nodeData[w].nextSibling)
+      {
+        nodeData[w].depth = nodeData[v].depth + 1;
+        queue[stackSize++] = w;
+      }
+    }
+  }
+
+  TUassertStackConsistency(tu);
 
   TU_GRAPH_NODE* nodesRows = NULL; /* Non-root node v is mapped to row of edge {v,predecessor(v)}. */
-  TU_CALL( TUallocStackArray(tu, &nodesRows, TUgraphMemNodes(graph)) );
+  TU_CALL( TUallocStackArray(tu, &nodesRows, memNodes) );
   char* nodesReversed = NULL; /* Non-root node v is mapped to +1 or -1 depending on the direction of {v,predecessor(v)}. */
-  TU_CALL( TUallocStackArray(tu, &nodesReversed, TUgraphMemNodes(graph)) );
+  TU_CALL( TUallocStackArray(tu, &nodesReversed, memNodes) );
   for (TU_GRAPH_NODE v = TUgraphNodesFirst(graph); TUgraphNodesValid(graph, v); v = TUgraphNodesNext(graph, v))
   {
     nodesRows[v] = -1;
@@ -215,8 +268,9 @@ TU_ERROR computeRepresentationMatrix(
     if (pisCorrectForest)
       *pisCorrectForest = false;
 
-    for (TU_GRAPH_NODE v = TUgraphNodesFirst(graph); TUgraphNodesValid(graph, v); v = TUgraphNodesNext(graph, v))
+    for (int i = 0; i < numOrderedNodes; ++i)
     {
+      TU_GRAPH_NODE v = orderedNodes[i];
       if (nodeData[v].predecessor >= 0 && nodeData[v].stage != BASIC)
       {
         nodesRows[v] = numRows;
@@ -229,6 +283,20 @@ TU_ERROR computeRepresentationMatrix(
     }
   }
 
+  /* Check whether rows appear in depth-first order. */
+  bool rowsOrdered = true;
+  int lastRow = -1;
+  for (int i = 0; i < numOrderedNodes; ++i)
+  {
+    int row = nodesRows[orderedNodes[i]];
+    if (row >= 0)
+    {
+      if (row < lastRow)
+        rowsOrdered = false;
+      lastRow = row;
+    }
+  }
+
   TUassertStackConsistency(tu);
 
   TU_CALL( TUchrmatCreate(tu, ptranspose, TUgraphNumEdges(graph) - numRows, numRows,
@@ -279,60 +347,62 @@ TU_ERROR computeRepresentationMatrix(
     transpose->rowStarts[numColumns] = numNonzeros;
     edgeColumns[e] = numColumns;
 
-    /* Enlarge space for nonzeros if necessary. */
-    if (numNonzeros + numRows > transpose->numNonzeros)
-      TU_CALL( TUchrmatChangeNumNonzeros(tu, transpose, 2 * transpose->numNonzeros) );
-
-    /* Compute u-root path. */
+    /* Compute the paths from u and v to their lowest common ancestor. */
     int uPathLength = 0;
-    TU_GRAPH_NODE w = u;
-    while (nodeData[w].predecessor != -1)
+    int vPathLength = 0;
+    while (nodeData[u].depth > nodeData[v].depth)
     {
-      uPath[uPathLength] = w;
-      ++uPathLength;
-      w = nodeData[w].predecessor;
+      uPath[uPathLength++] = u;
+      u = nodeData[u].predecessor;
     }
-
-    /* Compute v-root path. */
-    int vPathLength = 0;
-    w = v;
-    while (nodeData[w].predecessor != -1)
+    while (nodeData[v].depth > nodeData[u].depth)
     {
-      vPath[vPathLength] = w;
-      ++vPathLength;
-      w = nodeData[w].predecessor;
+      vPath[vPathLength++] = v;
+      v = nodeData[v].predecessor;
     }
-
-    /* Remove common part of u-root path and v-root path. */
-    while (uPathLength > 0 && vPathLength > 0 && uPath[uPathLength-1] == vPath[vPathLength-1])
+    while (u != v)
     {
-      --uPathLength;
-      --vPathLength;
+      uPath[uPathLength++] = u;
+      u = nodeData[u].predecessor;
+      vPath[vPathLength++] = v;
+      v = nodeData[v].predecessor;
     }
 
-    /* Create nonzeros. */
-    for (int j = 0; j < uPathLength; ++j)
+    /* Enlarge space for nonzeros if necessary. */
+    if (numNonzeros + uPathLength + vPathLength > transpose->numNonzeros)
     {
-      assert(nodesRows[uPath[j]] >= 0);
-      transpose->entryColumns[numNonzeros] = nodesRows[uPath[j]];
-      transpose->entryValues[numNonzeros] = ternary ? -nodesReversed[uPath[j]] : 1;
-      TUdbgMsg(4, "u: row %d. nodesReversed = %d, result = %d\n", nodesRows[uPath[j]],
-        nodesReversed[uPath[j]], transpose->entryValues[numNonzeros]);
-      ++numNonzeros;
+      int newNumNonzeros = 2 * transpose->numNonzeros;
+      if (newNumNonzeros < numNonzeros + uPathLength + vPathLength)
+        newNumNonzeros = numNonzeros + uPathLength + vPathLength;
+      TU_CALL( TUchrmatChangeNumNonzeros(tu, transpose, newNumNonzeros) );
     }
-    for (int j = 0; j < vPathLength; ++j)
+
+    /* Create nonzeros by merging both paths, starting at the lowest common ancestor. */
+    int uIndex = uPathLength - 1;
+    int vIndex = vPathLength - 1;
+    while (uIndex >= 0 || vIndex >= 0)
     {
-      assert(nodesRows[vPath[j]] >= 0);
-      transpose->entryColumns[numNonzeros] = nodesRows[vPath[j]];
-      transpose->entryValues[numNonzeros] = ternary ? nodesReversed[vPath[j]] : 1;
-      TUdbgMsg(4, "v: row %d. nodesReversed = %d, result = %d\n", nodesRows[vPath[j]],
-        nodesReversed[vPath[j]], transpose->entryValues[numNonzeros]);
+      if (vIndex < 0 || (uIndex >= 0 && nodeData[uPath[uIndex]].order < nodeData[vPath[vIndex]].order))
+      {
+        TU_GRAPH_NODE w = uPath[uIndex--];
+        assert(nodesRows[w] >= 0);
+        transpose->entryColumns[numNonzeros] = nodesRows[w];
+        transpose->entryValues[numNonzeros] = ternary ? -nodesReversed[w] : 1;
+        TUdbgMsg(4, "u: row %d. nodesReversed = %d, result = %d\n", nodesRows[w], nodesReversed[w],
+          transpose->entryValues[numNonzeros]);
+      }
+      else
+      {
+        TU_GRAPH_NODE w = vPath[vIndex--];
+        assert(nodesRows[w] >= 0);
+        transpose->entryColumns[numNonzeros] = nodesRows[w];
+        transpose->entryValues[numNonzeros] = ternary ? nodesReversed[w] : 1;
+        TUdbgMsg(4, "v: row %d. nodesReversed = %d, result = %d\n", nodesRows[w], nodesReversed[w],
+          transpose->entryValues[numNonzeros]);
+      }
       ++numNonzeros;
     }
 
-    TU_CALL( TUsort2(tu, uPathLength + vPathLength, &transpose->entryColumns[transpose->rowStarts[numColumns]],
-      sizeof(int), &transpose->entryValues[transpose->rowStarts[numColumns]], sizeof(char), compareInt2) );
-
     ++numColumns;
   }
 
@@ -343,6 +413,51 @@ TU_ERROR computeRepresentationMatrix(
   TU_CALL( TUfreeStackArray(tu, &edgeColumns) );
 
   transpose->rowStarts[numColumns] = numNonzeros;
+
+  if (!rowsOrdered && numNonzeros > 0)
+  {
+    /* Sort all columns at once by distributing the nonzeros to the rows and collecting them again. */
+    int* rowStarts = NULL;
+    TU_CALL( TUallocStackArray(tu, &rowStarts, numRows + 1) );
+    int* rowEntryColumns = NULL;
+    TU_CALL( TUallocStackArray(tu, &rowEntryColumns, numNonzeros) );
+    char* rowEntryValues = NULL;
+    TU_CALL( TUallocStackArray(tu, &rowEntryValues, numNonzeros) );
+    int* columnStarts = NULL;
+    TU_CALL( TUallocStackArray(tu, &columnStarts, numColumns) );
+
+    for (int row = 0; row <= numRows; ++row)
+      rowStarts[row] = 0;
+    for (int e = 0; e < numNonzeros; ++e)
+      rowStarts[transpose->entryColumns[e] + 1]++;
+    for (int row = 1; row <= numRows; ++row)
+      rowStarts[row] += rowStarts[row-1];
+    for (int column = 0; column < numColumns; ++column)
+    {
+      columnStarts[column] = transpose->rowStarts[column];
+      for (int e = transpose->rowStarts[column]; e < transpose->rowStarts[column+1]; ++e)
+      {
+        int entry = rowStarts[transpose->entryColumns[e]]++;
+        rowEntryColumns[entry] = column;
+        rowEntryValues[entry] = transpose->entryValues[e];
+      }
+    }
+    for (int row = 0, entry = 0; row < numRows; ++row)
+    {
+      for (; entry < rowStarts[row]; ++entry)
+      {
+        int e = columnStarts[rowEntryColumns[entry]]++;
+        transpose->entryColumns[e] = row;
+        transpose->entryValues[e] = rowEntryValues[entry];
+      }
+    }
+
+    TU_CALL( TUfreeStackArray(tu, &columnStarts) );
+    TU_CALL( TUfreeStackArray(tu, &rowEntryValues) );
+    TU_CALL( TUfreeStackArray(tu, &rowEntryColumns) );
+    TU_CALL( TUfreeStackArray(tu, &rowStarts) );
+  }
+
   if (numNonzeros == 0 && transpose->numNonzeros > 0)
   {
     TU_CALL( TUfreeBlockArray(tu, &transpose->entryColumns) );
@@ -350,13 +465,12 @@ TU_ERROR computeRepresentationMatrix(
   }
   transpose->numNonzeros = numNonzeros;
 
-  /* We now process the nonbasic edges. */
-
   TUassertStackConsistency(tu);
   TU_CALL( TUfreeStackArray(tu, &nodesReversed) );
-  TUassertStackConsistency(tu);
   TU_CALL( TUfreeStackArray(tu, &nodesRows) );
-  TUassertStackConsistency(tu);
+  TU_CALL( TUfreeStackArray(tu, &orderedNodes) );
+  TU_CALL( TUfreeStackArray(tu, &queue) );
+  TU_CALL( TUfreeStackArray(tu, &lengths) );
   TU_CALL( TUfreeStackArray(tu, &nodeData) );
 
   TUassertStackConsistency(tu);
@@ -1596,9 +1710,9 @@ TU_ERROR decToGraph(
   {
 #if !defined(NDEBUG)
     /* This is only relevant if a 1-separation exists. */
-    for (int r = 0; r < dec->numRows; ++r)
+    for (int r = 0; forestEdges && r < dec->numRows; ++r)
       forestEdges[r] = INT_MIN;
-    for (int c = 0; c < dec->numColumns; ++c)
+    for (int c = 0; coforestEdges && c < dec->numColumns; ++c)
       coforestEdges[c] = INT_MIN;
 #endif /* !NDEBUG */
 
@@ -1625,9 +1739,9 @@ TU_ERROR decToGraph(
 
 #if !defined(NDEBUG)
     /* These assertions indicate a 1-separable input matrix. */
-    for (int r = 0; r < dec->numRows; ++r)
+    for (int r = 0; forestEdges && r < dec->numRows; ++r)
       assert(forestEdges[r] >= 0);
-    for (int c = 0; c < dec->numColumns; ++c)
+    for (int c = 0; coforestEdges && c < dec->numColumns; ++c)
       assert(coforestEdges[c] >= 0);
 #endif /* !NDEBUG */
   }
@@ -1897,13 +2011,11 @@ TU_ERROR removeAllPathEdges(
     if (dec->members[member].type == DEC_MEMBER_TYPE_RIGID)
     {
       DEC_NODE tail = findEdgeTail(dec, edge);
-      if (tail >= newcolumn->memNodesDegree)
-        continue;
+      if (tail < newcolumn->memNodesDegree)
+        newcolumn->nodesDegree[tail] = 0;
       DEC_NODE head = findEdgeHead(dec, edge);
-      if (head >= newcolumn->memNodesDegree)
-        continue;
-      newcolumn->nodesDegree[tail] = 0;
-      newcolumn->nodesDegree[head] = 0;
+      if (head < newcolumn->memNodesDegree)
+        newcolumn->nodesDegree[head] = 0;
       TUdbgMsg(0, "Set nodesDegree of nodes of edge %d = {%d,%d} to 0.\n", edge, tail, head);
     }
   }
@@ -2059,7 +2171,7 @@ TU_ERROR parallelParentChildCheckReducedMembers(
 )
 {
   assert(dec);
-  assert(entryRows);
+  assert(entryRows || numEntries == 0);
 
   dec->parallelParentChildVisit++;
 
@@ -2916,17 +3028,19 @@ TU_ERROR determineTypeRigid(
       }
       else if (numOneEnd == 2)
       {
-        bool matched[2] = { false, false };
+        /* The path ends must be matched to distinct child markers, i.e., it does not suffice that each child marker
+         * is incident to some path end node. */
+        bool incident[2][2];
         for (int i = 0; i < 2; ++i)
         {
-          for (int j = 0; j < 4; ++j)
+          for (int c = 0; c < 2; ++c)
           {
-            if (reducedMember->rigidEndNodes[i] == childMarkerNodes[j])
-              matched[j/2] = true;
+            incident[i][c] = reducedMember->rigidEndNodes[i] == childMarkerNodes[2*c]
+              || reducedMember->rigidEndNodes[i] == childMarkerNodes[2*c + 1];
           }
         }
 
-        if (matched[0] && matched[1])
+        if ((incident[0][0] && incident[1][1]) || (incident[0][1] && incident[1][0]))
           reducedMember->type = TYPE_ROOT;
         else
         {
@@ -3401,7 +3515,7 @@ TU_ERROR addColumnCheck(
 {
   assert(dec);
   assert(newcolumn);
-  assert(rows);
+  assert(rows || numRows == 0);
 
   TUdbgMsg(0, "\n  Checking whether we can add a column with %d 1's.\n", numRows);
 
@@ -5207,6 +5321,599 @@ TU_ERROR addColumnApply(
   return TU_OKAY;
 }
 
+/**
+ * \brief Adds a single-edge parallel member for each row that does not appear in the decomposition yet.
+ */
+
+static
+TU_ERROR decAddEmptyRows(
+  Dec* dec,   /**< Decomposition. */
+  int numRows /**< Number of rows the decomposition shall have. */
+)
+{
+  assert(dec);
+
+  if (dec->numRows >= numRows)
+    return TU_OKAY;
+
+  /* Reallocate if necessary. */
+  if (dec->memRows < numRows)
+  {
+    TU_CALL( TUreallocBlockArray(dec->tu, &dec->rowEdges, numRows) );
+    dec->memRows = numRows;
+  }
+
+  /* Add single-edge parallel for each missing row. */
+  for (int r = dec->numRows; r < numRows; ++r)
+  {
+    DEC_MEMBER member;
+    TU_CALL( createMember(dec, DEC_MEMBER_TYPE_PARALLEL, &member) );
+
+    DEC_EDGE edge;
+    TU_CALL( createEdge(dec, member, &edge) );
+    TU_CALL( addEdgeToMembersEdgeList(dec, edge) );
+    dec->edges[edge].element = TUrowToElement(r);
+    dec->edges[edge].head = -1;
+    dec->edges[edge].tail = -1;
+    dec->edges[edge].childMember = -1;
+
+    TUdbgMsg(8, "New empty row %d is edge %d of member %d.\n", r, edge, member);
+
+    dec->rowEdges[r].edge = edge;
+  }
+
+  dec->numRows = numRows;
+
+  return TU_OKAY;
+}
+
+/**
+ * \brief Tests a submatrix of \f$ M \f$ for graphicness by adding its columns one by one.
+ *
+ * The submatrix consists of the rows \c r with \p rowsMap[r] >= 0, which become row \p rowsMap[r] of the submatrix,
+ * and of the given \p columns, which are added in this order. The position in \p columns of the first column that
+ * destroys graphicness is stored in *\p pfailingColumn, which is -1 if the submatrix is graphic.
+ */
+
+static
+TU_ERROR testSubmatrixBinaryGraphic(
+  TU* tu,               /**< \ref TU environment. */
+  TU_CHRMAT* transpose, /**< \f$ M^{\mathsf{T}} \f$ */
+  int* rowsMap,         /**< Map from rows of \f$ M \f$ to rows of the submatrix, or -1. */
+  int numColumns,       /**< Length of \p columns. */
+  int* columns,         /**< Columns of the submatrix. */
+  int* pfailingColumn   /**< Pointer for storing the position of the first violating column, or -1. */
+)
+{
+  assert(tu);
+  assert(transpose);
+  assert(rowsMap);
+  assert(pfailingColumn);
+
+  *pfailingColumn = -1;
+
+  int* rows = NULL;
+  TU_CALL( TUallocStackArray(tu, &rows, transpose->numColumns) );
+  Dec* dec = NULL;
+  TU_CALL( decCreate(tu, &dec, 256, 64, 64, 64, 64) );
+  DEC_NEWCOLUMN* newcolumn = NULL;
+  TU_CALL( newcolumnCreate(tu, &newcolumn) );
+
+  for (int i = 0; i < numColumns; ++i)
+  {
+    int column = columns[i];
+    int first = transpose->rowStarts[column];
+    int beyond = column + 1 < transpose->numRows ? transpose->rowStarts[column+1] : transpose->numNonzeros;
+    int numRows = 0;
+    for (int e = first; e < beyond; ++e)
+    {
+      if (rowsMap[transpose->entryColumns[e]] >= 0)
+        rows[numRows++] = rowsMap[transpose->entryColumns[e]];
+    }
+
+    TU_CALL( addColumnCheck(dec, newcolumn, rows, numRows) );
+    if (!newcolumn->remainsGraphic)
+    {
+      *pfailingColumn = i;
+      break;
+    }
+    TU_CALL( addColumnApply(dec, newcolumn, i, rows, numRows) );
+  }
+
+  TU_CALL( newcolumnFree(tu, &newcolumn) );
+  TU_CALL( decFree(&dec) );
+  TU_CALL( TUfreeStackArray(tu, &rows) );
+
+  return TU_OKAY;
+}
+
+/**
+ * \brief Finds an element of \f$ M \f$ that can take the place of \p marker, given such elements for the other
+ * markers of its member.
+ *
+ * The markers behind the other marker edges of the member of \p marker must be stored at \p markersSpan and
+ * \p markerRepresentatives from index \p firstBehind on, in the order of the member's edges.
+ */
+
+static
+TU_ERROR representMarker(
+  Dec* dec,                       /**< Decomposition. */
+  DEC_EDGE marker,                /**< Marker edge. */
+  int* nodeIndices,               /**< Array of size \c dec->memNodes with -1 entries, which are restored on return. */
+  bool* markersSpan,              /**< Array indicating whether the rows behind a marker span it. */
+  Element* markerRepresentatives, /**< Array of representatives of markers. */
+  int firstBehind,                /**< Index of the first marker behind the other marker edges. */
+  bool* pspans,                   /**< Pointer for storing whether the rows connect the end nodes of \p marker. */
+  Element* prepresentative        /**< Pointer for storing the element. */
+)
+{
+  assert(dec);
+  assert(nodeIndices);
+  assert(markersSpan);
+  assert(markerRepresentatives);
+  assert(pspans);
+  assert(prepresentative);
+
+  int nextBehind = firstBehind;
+
+  DEC_MEMBER member = findEdgeMember(dec, marker);
+  DEC_MEMBER_TYPE type = dec->members[member].type;
+  assert(type != DEC_MEMBER_TYPE_LOOP);
+
+  /* Each other marker edge is replaced by the element found for the marker behind it. */
+  int numEdges = 0;
+  DEC_EDGE* edges = NULL;
+  TU_CALL( TUallocStackArray(dec->tu, &edges, dec->members[member].numEdges) );
+  bool* edgesSpan = NULL;
+  TU_CALL( TUallocStackArray(dec->tu, &edgesSpan, dec->members[member].numEdges) );
+  Element* representatives = NULL;
+  TU_CALL( TUallocStackArray(dec->tu, &representatives, dec->members[member].numEdges) );
+  DEC_EDGE edge = dec->members[member].firstEdge;
+  do
+  {
+    if (edge != marker)
+    {
+      if (dec->edges[edge].childMember >= 0
+        || (dec->members[member].parentMember >= 0 && edge == dec->members[member].markerToParent))
+      {
+        edgesSpan[numEdges] = markersSpan[nextBehind];
+        representatives[numEdges] = markerRepresentatives[nextBehind];
+        ++nextBehind;
+      }
+      else
+      {
+        edgesSpan[numEdges] = TUelementIsRow(dec->edges[edge].element);
+        representatives[numEdges] = dec->edges[edge].element;
+      }
+      edges[numEdges++] = edge;
+    }
+    edge = dec->edges[edge].next;
+  }
+  while (edge != dec->members[member].firstEdge);
+  assert(numEdges > 0);
+
+  *pspans = false;
+  *prepresentative = representatives[0];
+  if (type == DEC_MEMBER_TYPE_PARALLEL)
+  {
+    /* The marker is parallel to all other edges, so a single spanning one suffices. */
+    for (int i = 0; i < numEdges; ++i)
+    {
+      if (edgesSpan[i])
+      {
+        *pspans = true;
+        *prepresentative = representatives[i];
+        break;
+      }
+    }
+  }
+  else if (type == DEC_MEMBER_TYPE_SERIES)
+  {
+    /* The other edges form a path between the end nodes, so all of them must span. */
+    *pspans = true;
+    for (int i = 0; i < numEdges; ++i)
+    {
+      if (!edgesSpan[i])
+      {
+        *pspans = false;
+        *prepresentative = representatives[i];
+        break;
+      }
+    }
+  }
+  else
+  {
+    assert(type == DEC_MEMBER_TYPE_RIGID);
+
+    /* Breadth-first search from the tail of the marker along spanning edges. */
+    int numNodes = 0;
+    int* tails = NULL;
+    TU_CALL( TUallocStackArray(dec->tu, &tails, numEdges) );
+    int* heads = NULL;
+    TU_CALL( TUallocStackArray(dec->tu, &heads, numEdges) );
+    DEC_NODE* nodes = NULL;
+    TU_CALL( TUallocStackArray(dec->tu, &nodes, 2 * numEdges + 2) );
+    for (int i = -1; i < numEdges; ++i)
+    {
+      DEC_EDGE e = i < 0 ? marker : edges[i];
+      DEC_NODE ends[2] = { findEdgeTail(dec, e), findEdgeHead(dec, e) };
+      for (int j = 0; j < 2; ++j)
+      {
+        if (nodeIndices[ends[j]] < 0)
+        {
+          nodeIndices[ends[j]] = numNodes;
+          nodes[numNodes++] = ends[j];
+        }
+      }
+      if (i >= 0)
+      {
+        tails[i] = nodeIndices[ends[0]];
+        heads[i] = nodeIndices[ends[1]];
+      }
+    }
+
+    /* Adjacency lists of the spanning edges. */
+    int* firstAdjacent = NULL;
+    TU_CALL( TUallocStackArray(dec->tu, &firstAdjacent, numNodes + 1) );
+    int* adjacentEdges = NULL;
+    TU_CALL( TUallocStackArray(dec->tu, &adjacentEdges, 2 * numEdges) );
+    for (int v = 0; v <= numNodes; ++v)
+      firstAdjacent[v] = 0;
+    for (int i = 0; i < numEdges; ++i)
+    {
+      if (edgesSpan[i])
+      {
+        firstAdjacent[tails[i]]++;
+        firstAdjacent[heads[i]]++;
+      }
+    }
+    for (int v = 1; v <= numNodes; ++v)
+      firstAdjacent[v] += firstAdjacent[v-1];
+    for (int i = 0; i < numEdges; ++i)
+    {
+      if (edgesSpan[i])
+      {
+        adjacentEdges[--firstAdjacent[tails[i]]] = i;
+        adjacentEdges[--firstAdjacent[heads[i]]] = i;
+      }
+    }
+
+    int* predecessorEdges = NULL;
+    TU_CALL( TUallocStackArray(dec->tu, &predecessorEdges, numNodes) );
+    int* queue = NULL;
+    TU_CALL( TUallocStackArray(dec->tu, &queue, numNodes) );
+    for (int v = 0; v < numNodes; ++v)
+      predecessorEdges[v] = -2;
+    int source = nodeIndices[findEdgeTail(dec, marker)];
+    int target = nodeIndices[findEdgeHead(dec, marker)];
+    predecessorEdges[source] = -1;
+    queue[0] = source;
+    int queueEnd = 1;
+    for (int q = 0; q < queueEnd; ++q)
+    {
+      int v = queue[q];
+      for (int a = firstAdjacent[v]; a < firstAdjacent[v+1]; ++a)
+      {
+        int i = adjacentEdges[a];
+        int w = tails[i] == v ? heads[i] : tails[i];
+        if (predecessorEdges[w] == -2)
+        {
+          predecessorEdges[w] = i;
+          queue[queueEnd++] = w;
+        }
+      }
+    }
+
+    if (predecessorEdges[target] >= 0)
+    {
+      /* Any edge of the path to the head will do. */
+      *pspans = true;
+      *prepresentative = representatives[predecessorEdges[target]];
+    }
+    else
+    {
+      /* The spanning edges form two trees, and some other edge connects them. */
+      int i;
+      for (i = 0; i < numEdges; ++i)
+      {
+        if ((predecessorEdges[tails[i]] == -2) != (predecessorEdges[heads[i]] == -2))
+          break;
+      }
+      assert(i < numEdges);
+      assert(!edgesSpan[i]);
+      *prepresentative = representatives[i];
+    }
+
+    for (int v = 0; v < numNodes; ++v)
+      nodeIndices[nodes[v]] = -1;
+
+    TU_CALL( TUfreeStackArray(dec->tu, &queue) );
+    TU_CALL( TUfreeStackArray(dec->tu, &predecessorEdges) );
+    TU_CALL( TUfreeStackArray(dec->tu, &adjacentEdges) );
+    TU_CALL( TUfreeStackArray(dec->tu, &firstAdjacent) );
+    TU_CALL( TUfreeStackArray(dec->tu, &nodes) );
+    TU_CALL( TUfreeStackArray(dec->tu, &heads) );
+    TU_CALL( TUfreeStackArray(dec->tu, &tails) );
+  }
+
+  TUdbgMsg(8, "Marker %d of member %d is represented by %s, which %s.\n", marker, member,
+    TUelementString(*prepresentative, NULL), *pspans ? "spans" : "does not span");
+  assert(TUelementIsRow(*prepresentative) == *pspans);
+
+  TU_CALL( TUfreeStackArray(dec->tu, &representatives) );
+  TU_CALL( TUfreeStackArray(dec->tu, &edgesSpan) );
+  TU_CALL( TUfreeStackArray(dec->tu, &edges) );
+
+  return TU_OKAY;
+}
+
+/**
+ * \brief Finds an element of \f$ M \f$ that can take the place of \p marker.
+ *
+ * Considers the part of the decomposition behind \p marker, that is, the member of \p marker and all members reached
+ * from there without using \p marker. Contracting all rows and deleting all columns of this part except for the
+ * returned element turns this element into a copy of \p marker. The element is a row if and only if the rows of this
+ * part connect the end nodes of \p marker, which is stored in *\p pspans.
+ *
+ * The members are processed in reverse breadth-first order, such that the markers behind a member are replaced first.
+ */
+
+static
+TU_ERROR findMarkerRepresentative(
+  Dec* dec,                 /**< Decomposition. */
+  DEC_EDGE marker,          /**< Marker edge. */
+  int* nodeIndices,         /**< Array of size \c dec->memNodes with -1 entries, which are restored on return. */
+  bool* pspans,             /**< Pointer for storing whether the rows connect the end nodes of \p marker. */
+  Element* prepresentative  /**< Pointer for storing the element. */
+)
+{
+  assert(dec);
+  assert(nodeIndices);
+  assert(pspans);
+  assert(prepresentative);
+
+  /* Each member behind marker is reached via exactly one marker. The markers behind the other marker edges of
+   * markers[k]'s member are markers[firstBehind[k]], ..., in the order of the member's edges. */
+  DEC_EDGE* markers = NULL;
+  TU_CALL( TUallocStackArray(dec->tu, &markers, dec->numMembers) );
+  int* firstBehind = NULL;
+  TU_CALL( TUallocStackArray(dec->tu, &firstBehind, dec->numMembers) );
+  bool* markersSpan = NULL;
+  TU_CALL( TUallocStackArray(dec->tu, &markersSpan, dec->numMembers) );
+  Element* markerRepresentatives = NULL;
+  TU_CALL( TUallocStackArray(dec->tu, &markerRepresentatives, dec->numMembers) );
+
+  int numMarkers = 1;
+  markers[0] = marker;
+  for (int k = 0; k < numMarkers; ++k)
+  {
+    DEC_MEMBER member = findEdgeMember(dec, markers[k]);
+    firstBehind[k] = numMarkers;
+    DEC_EDGE edge = dec->members[member].firstEdge;
+    do
+    {
+      if (edge != markers[k])
+      {
+        if (dec->edges[edge].childMember >= 0)
+        {
+          DEC_MEMBER child = findMember(dec, dec->edges[edge].childMember);
+          assert(numMarkers < dec->numMembers);
+          markers[numMarkers++] = dec->members[child].markerToParent;
+        }
+        else if (dec->members[member].parentMember >= 0 && edge == dec->members[member].markerToParent)
+        {
+          assert(numMarkers < dec->numMembers);
+          markers[numMarkers++] = dec->members[member].markerOfParent;
+        }
+      }
+      edge = dec->edges[edge].next;
+    }
+    while (edge != dec->members[member].firstEdge);
+  }
+
+  for (int k = numMarkers - 1; k >= 0; --k)
+  {
+    TU_CALL( representMarker(dec, markers[k], nodeIndices, markersSpan, markerRepresentatives, firstBehind[k],
+      &markersSpan[k], &markerRepresentatives[k]) );
+  }
+  *pspans = markersSpan[0];
+  *prepresentative = markerRepresentatives[0];
+
+  TU_CALL( TUfreeStackArray(dec->tu, &markerRepresentatives) );
+  TU_CALL( TUfreeStackArray(dec->tu, &markersSpan) );
+  TU_CALL( TUfreeStackArray(dec->tu, &firstBehind) );
+  TU_CALL( TUfreeStackArray(dec->tu, &markers) );
+
+  return TU_OKAY;
+}
+
+/**
+ * \brief Computes a minimal nongraphic submatrix after adding \p failingColumn to \p dec destroyed graphicness.
+ *
+ * The matroid of \p dec is a 2-sum of the members of the reduced decomposition in \p newcolumn with graphic
+ * matroids that are attached at the other marker edges of these members. Since 2-sums of graphic matroids are graphic,
+ * the reduced members together with \p failingColumn are nongraphic if each such marker is replaced by an element of
+ * its graphic part, see \ref findMarkerRepresentative. The rows and columns of these elements form a nongraphic
+ * submatrix, which is then made minimal by trying to remove each of its rows and columns once. A single pass
+ * suffices since a submatrix of a graphic matrix is graphic.
+ */
+
+static
+TU_ERROR computeNongraphicSubmatrix(
+  TU* tu,                   /**< \ref TU environment. */
+  TU_CHRMAT* transpose,     /**< \f$ M^{\mathsf{T}} \f$ */
+  Dec* dec,                 /**< Decomposition of the columns before \p failingColumn. */
+  DEC_NEWCOLUMN* newcolumn, /**< newcolumn after checking \p failingColumn. */
+  int failingColumn,        /**< Column whose addition destroys graphicness. */
+  TU_SUBMAT** psubmatrix    /**< Pointer for storing the submatrix. */
+)
+{
+  assert(tu);
+  assert(transpose);
+  assert(dec);
+  assert(newcolumn);
+  assert(!newcolumn->remainsGraphic);
+  assert(psubmatrix);
+
+  int numRows = transpose->numColumns;
+
+  /* Collect the members of all reduced components, parents before children. */
+  bool* membersReduced = NULL;
+  TU_CALL( TUallocStackArray(tu, &membersReduced, dec->memMembers) );
+  for (int m = 0; m < dec->memMembers; ++m)
+    membersReduced[m] = false;
+  ReducedMember** reducedMembers = NULL;
+  TU_CALL( TUallocStackArray(tu, &reducedMembers, newcolumn->numReducedMembers) );
+  int numReducedMembers = 0;
+  for (int i = 0; i < newcolumn->numReducedComponents; ++i)
+  {
+    reducedMembers[numReducedMembers++] = newcolumn->reducedComponents[i].root;
+    membersReduced[newcolumn->reducedComponents[i].root->member] = true;
+  }
+  for (int i = 0; i < numReducedMembers; ++i)
+  {
+    for (int c = 0; c < reducedMembers[i]->numChildren; ++c)
+    {
+      reducedMembers[numReducedMembers++] = reducedMembers[i]->children[c];
+      membersReduced[reducedMembers[i]->children[c]->member] = true;
+    }
+  }
+
+  /* Select the elements of these members, using representatives for the other markers. */
+  int* rowsMap = NULL;
+  TU_CALL( TUallocStackArray(tu, &rowsMap, numRows) );
+  for (int row = 0; row < numRows; ++row)
+    rowsMap[row] = -1;
+  bool* columnsSelected = NULL;
+  TU_CALL( TUallocStackArray(tu, &columnsSelected, failingColumn) );
+  for (int column = 0; column < failingColumn; ++column)
+    columnsSelected[column] = false;
+  int* nodeIndices = NULL;
+  TU_CALL( TUallocStackArray(tu, &nodeIndices, dec->memNodes) );
+  for (int v = 0; v < dec->memNodes; ++v)
+    nodeIndices[v] = -1;
+
+  for (int i = 0; i < numReducedMembers; ++i)
+  {
+    DEC_MEMBER member = reducedMembers[i]->member;
+    DEC_EDGE edge = dec->members[member].firstEdge;
+    do
+    {
+      Element element = dec->edges[edge].element;
+      bool spans;
+      if (dec->edges[edge].childMember >= 0)
+      {
+        DEC_MEMBER child = findMember(dec, dec->edges[edge].childMember);
+        if (membersReduced[child])
+          element = 0;
+        else
+        {
+          TU_CALL( findMarkerRepresentative(dec, dec->members[child].markerToParent, nodeIndices, &spans,
+            &element) );
+        }
+      }
+      else if (dec->members[member].parentMember >= 0 && edge == dec->members[member].markerToParent)
+      {
+        if (i < newcolumn->numReducedComponents)
+        {
+          TU_CALL( findMarkerRepresentative(dec, dec->members[member].markerOfParent, nodeIndices, &spans,
+            &element) );
+        }
+        else
+          element = 0;
+      }
+
+      if (TUelementIsRow(element))
+        rowsMap[TUelementToRowIndex(element)] = 0;
+      else if (TUelementIsColumn(element))
+        columnsSelected[TUelementToColumnIndex(element)] = true;
+      edge = dec->edges[edge].next;
+    }
+    while (edge != dec->members[member].firstEdge);
+  }
+
+  int* columns = NULL;
+  TU_CALL( TUallocStackArray(tu, &columns, failingColumn + 1) );
+  int numColumns = 0;
+  for (int column = 0; column < failingColumn; ++column)
+  {
+    if (columnsSelected[column])
+      columns[numColumns++] = column;
+  }
+  columns[numColumns++] = failingColumn;
+  int numSelectedRows = 0;
+  for (int row = 0; row < numRows; ++row)
+  {
+    if (rowsMap[row] >= 0)
+      rowsMap[row] = numSelectedRows++;
+  }
+
+  TUdbgMsg(2, "Reduced members yield a nongraphic %dx%d submatrix.\n", numSelectedRows, numColumns);
+
+  int failing;
+#if !defined(NDEBUG)
+  TU_CALL( testSubmatrixBinaryGraphic(tu, transpose, rowsMap, numColumns, columns, &failing) );
+  assert(failing == numColumns - 1);
+#endif /* !NDEBUG */
+
+  /* All other columns form a graphic submatrix, so the failing column is never removed. */
+  for (int i = numColumns - 2; i >= 0; --i)
+  {
+    int column = columns[i];
+    for (int j = i + 1; j < numColumns; ++j)
+      columns[j-1] = columns[j];
+    TU_CALL( testSubmatrixBinaryGraphic(tu, transpose, rowsMap, numColumns - 1, columns, &failing) );
+    if (failing >= 0)
+      --numColumns;
+    else
+    {
+      for (int j = numColumns - 1; j > i; --j)
+        columns[j] = columns[j-1];
+      columns[i] = column;
+    }
+  }
+  for (int row = 0; row < numRows; ++row)
+  {
+    int rowImage = rowsMap[row];
+    if (rowImage < 0)
+      continue;
+
+    rowsMap[row] = -1;
+    TU_CALL( testSubmatrixBinaryGraphic(tu, transpose, rowsMap, numColumns, columns, &failing) );
+    if (failing < 0)
+      rowsMap[row] = rowImage;
+  }
+
+  /* Create the submatrix. */
+  numSelectedRows = 0;
+  for (int row = 0; row < numRows; ++row)
+  {
+    if (rowsMap[row] >= 0)
+      ++numSelectedRows;
+  }
+  TU_CALL( TUsubmatCreate(tu, psubmatrix, numSelectedRows, numColumns) );
+  TU_SUBMAT* submatrix = *psubmatrix;
+  submatrix->numRows = 0;
+  for (int row = 0; row < numRows; ++row)
+  {
+    if (rowsMap[row] >= 0)
+      submatrix->rows[submatrix->numRows++] = row;
+  }
+  for (int i = 0; i < numColumns; ++i)
+    submatrix->columns[i] = columns[i];
+
+  TU_CALL( TUfreeStackArray(tu, &columns) );
+  TU_CALL( TUfreeStackArray(tu, &nodeIndices) );
+  TU_CALL( TUfreeStackArray(tu, &columnsSelected) );
+  TU_CALL( TUfreeStackArray(tu, &rowsMap) );
+  TU_CALL( TUfreeStackArray(tu, &reducedMembers) );
+  TU_CALL( TUfreeStackArray(tu, &membersReduced) );
+
+  TUdbgMsg(2, "Found a nongraphic %dx%d submatrix.\n", submatrix->numRows, submatrix->numColumns);
+
+  return TU_OKAY;
+}
+
 TU_ERROR TUtestBinaryGraphic(TU* tu, TU_CHRMAT* transpose, bool* pisGraphic, TU_GRAPH** pgraph,
   TU_GRAPH_EDGE** pforestEdges, TU_GRAPH_EDGE** pcoforestEdges, TU_SUBMAT** psubmatrix)
 {
@@ -5234,6 +5941,12 @@ TU_ERROR TUtestBinaryGraphic(TU* tu, TU_CHRMAT* transpose, bool* pisGraphic, TU_
     TU_CALL( newcolumnCreate(tu, &newcolumn) );
     for (int column = 0; column < transpose->numRows && *pisGraphic; ++column)
     {
+      if (TUtasksCancelled(tu))
+      {
+        *pisGraphic = false;
+        break;
+      }
+
       TU_CALL( addColumnCheck(dec, newcolumn, &transpose->entryColumns[transpose->rowStarts[column]],
         transpose->rowStarts[column+1] - transpose->rowStarts[column]) );
 
@@ -5245,7 +5958,11 @@ TU_ERROR TUtestBinaryGraphic(TU* tu, TU_CHRMAT* transpose, bool* pisGraphic, TU_
           transpose->rowStarts[column+1] - transpose->rowStarts[column]) );
       }
       else
+      {
         *pisGraphic = false;
+        if (psubmatrix)
+          TU_CALL( computeNongraphicSubmatrix(tu, transpose, dec, newcolumn, column, psubmatrix) );
+      }
     }
 
     TU_CALL( newcolumnFree(tu, &newcolumn) );
@@ -5285,38 +6002,7 @@ TU_ERROR TUtestBinaryGraphic(TU* tu, TU_CHRMAT* transpose, bool* pisGraphic, TU_
     {
       if (transpose->numNonzeros > 0)
       {
-        /* Add members and edges for empty rows. */
-        if (dec->numRows < transpose->numColumns)
-        {
-          /* Reallocate if necessary. */
-          if (dec->memRows < transpose->numColumns)
-          {
-            TUreallocBlockArray(tu, &dec->rowEdges, transpose->numColumns);
-            dec->memRows = transpose->numColumns;
-          }
-
-          /* Add single-edge parallel for each missing row. */
-          for (int r = dec->numRows; r < transpose->numColumns; ++r)
-          {
-            DEC_MEMBER member;
-            TU_CALL( createMember(dec, DEC_MEMBER_TYPE_PARALLEL, &member) );
-
-            DEC_EDGE edge;
-            TU_CALL( createEdge(dec, member, &edge) );
-            TU_CALL( addEdgeToMembersEdgeList(dec, edge) );
-            dec->edges[edge].element = TUrowToElement(r);
-            dec->edges[edge].head = -1;
-            dec->edges[edge].tail = -1;
-            dec->edges[edge].childMember = -1;
-
-            TUdbgMsg(8, "New empty row %d is edge %d of member %d.\n", r, edge, member);
-
-            dec->rowEdges[r].edge = edge;
-          }
-
-          dec->numRows = transpose->numColumns;
-        }
-
+        TU_CALL( decAddEmptyRows(dec, transpose->numColumns) );
         TU_CALL( decToGraph(dec, graph, true, forest, coforest, NULL) );
       }
       else
@@ -5355,6 +6041,130 @@ TU_ERROR TUtestBinaryGraphic(TU* tu, TU_CHRMAT* transpose, bool* pisGraphic, TU_
   return TU_OKAY;
 }
 
+struct _TU_GRAPHIC_DEC
+{
+  Dec* dec;                 /**< \brief Decomposition of the columns added so far. */
+  DEC_NEWCOLUMN* newcolumn; /**< \brief Working data for checking and adding columns. */
+  int numRows;              /**< \brief Number of rows. */
+  int numColumns;           /**< \brief Number of added columns. */
+};
+
+TU_ERROR TUgraphicDecCreate(TU* tu, TU_GRAPHIC_DEC** pgdec, int numRows)
+{
+  assert(tu);
+  assert(pgdec);
+  assert(!*pgdec);
+  assert(numRows >= 0);
+
+  TU_CALL( TUallocBlock(tu, pgdec) );
+  TU_GRAPHIC_DEC* gdec = *pgdec;
+  gdec->dec = NULL;
+  gdec->newcolumn = NULL;
+  gdec->numRows = numRows;
+  gdec->numColumns = 0;
+  TU_CALL( decCreate(tu, &gdec->dec, 4096, 1024, 256, numRows > 256 ? numRows : 256, 256) );
+  TU_CALL( newcolumnCreate(tu, &gdec->newcolumn) );
+
+  return TU_OKAY;
+}
+
+TU_ERROR TUgraphicDecFree(TU* tu, TU_GRAPHIC_DEC** pgdec)
+{
+  assert(tu);
+  assert(pgdec);
+
+  if (!*pgdec)
+    return TU_OKAY;
+
+  TU_CALL( newcolumnFree(tu, &(*pgdec)->newcolumn) );
+  TU_CALL( decFree(&(*pgdec)->dec) );
+  TU_CALL( TUfreeBlock(tu, pgdec) );
+
+  return TU_OKAY;
+}
+
+int TUgraphicDecNumRows(TU_GRAPHIC_DEC* gdec)
+{
+  assert(gdec);
+
+  return gdec->numRows;
+}
+
+int TUgraphicDecNumColumns(TU_GRAPHIC_DEC* gdec)
+{
+  assert(gdec);
+
+  return gdec->numColumns;
+}
+
+TU_ERROR TUgraphicDecAddColumn(TU* tu, TU_GRAPHIC_DEC* gdec, int* rows, int numRows, bool apply,
+  bool* pisGraphic)
+{
+  assert(tu);
+  assert(gdec);
+  assert(rows || numRows == 0);
+  assert(pisGraphic);
+
+#if !defined(NDEBUG)
+  for (int p = 0; p < numRows; ++p)
+    assert(rows[p] >= 0 && rows[p] < gdec->numRows);
+#endif /* !NDEBUG */
+
+  TUdbgMsg(0, "TUgraphicDecAddColumn for column %d with %d 1's.\n", gdec->numColumns, numRows);
+
+  TU_CALL( addColumnCheck(gdec->dec, gdec->newcolumn, rows, numRows) );
+  *pisGraphic = gdec->newcolumn->remainsGraphic;
+
+  if (apply && *pisGraphic)
+  {
+    TU_CALL( addColumnApply(gdec->dec, gdec->newcolumn, gdec->numColumns, rows, numRows) );
+    gdec->numColumns++;
+  }
+  else
+  {
+    /* Discard the reduced decomposition such that the next check starts from scratch. */
+    gdec->newcolumn->numReducedMembers = 0;
+    gdec->newcolumn->numReducedComponents = 0;
+  }
+
+  return TU_OKAY;
+}
+
+TU_ERROR TUgraphicDecGraph(TU* tu, TU_GRAPHIC_DEC* gdec, TU_GRAPH** pgraph, TU_GRAPH_EDGE** pforestEdges,
+  TU_GRAPH_EDGE** pcoforestEdges)
+{
+  assert(tu);
+  assert(gdec);
+  assert(pgraph);
+
+  if (!*pgraph)
+  {
+    TU_CALL( TUgraphCreateEmpty(tu, pgraph, gdec->numRows + 2 * gdec->numColumns,
+      gdec->numRows + 3 * gdec->numColumns) );
+  }
+
+  TU_GRAPH_EDGE* forest = NULL;
+  if (pforestEdges)
+  {
+    if (!*pforestEdges)
+      TU_CALL( TUallocBlockArray(tu, pforestEdges, gdec->numRows) );
+    forest = *pforestEdges;
+  }
+  TU_GRAPH_EDGE* coforest = NULL;
+  if (pcoforestEdges)
+  {
+    if (!*pcoforestEdges)
+      TU_CALL( TUallocBlockArray(tu, pcoforestEdges, gdec->numColumns) );
+    coforest = *pcoforestEdges;
+  }
+
+  /* Rows without a 1-entry so far become bridges of the graph. */
+  TU_CALL( decAddEmptyRows(gdec->dec, gdec->numRows) );
+  TU_CALL( decToGraph(gdec->dec, *pgraph, true, forest, coforest, NULL) );
+
+  return TU_OKAY;
+}
+
 typedef struct
 {
   int forestIndex;
@@ -1,574 +1,538 @@
 #pragma once
 
-#include <boost/graph/bipartite.hpp>
-#include <boost/graph/detail/set_adaptor.hpp>
-#include <boost/graph/filtered_graph.hpp>
-#include <boost/graph/connected_components.hpp>
-#include <boost/graph/biconnected_components.hpp>
-#include <boost/property_map/property_map.hpp>
+#include <atomic>
+#include <cassert>
+#include <new>
+#include <stdexcept>
 #include <vector>
 
+#include <tu/graphic.h>
 #include <tu/matroid_graph.hpp>
-#include "graph_utils.hpp"
-
-#include <boost/graph/adjacency_list_io.hpp>
 
 namespace tu
 {
-
-  /**
-   * Finds a matroid element which is parallel to a row element in minor of a given matroid or
-   * a unit vector in a column element in the minor.
-   *
-   * @param matroid The given matroid
-   * @param matrix Representation matrix of the given matroid
-   * @param minor_height Number of rows of the minor
-   * @param minor_width Number of columns of the minor
-   * @param row The element must be parallel to this row (along the minor)
-   * @return The matroid element that was found to be parallel / unit vector
-   */
-
-  template <typename MatroidType, typename MatrixType>
-  int find_parallel_to_row(const MatroidType& matroid, const MatrixType& matrix, const size_t minor_height,
-      const size_t minor_width, const size_t row)
+  namespace detail
   {
-    /// Look for unit vector
-    size_t last = 0;
-    size_t count = 0;
-    for (size_t c = 0; c < minor_width; ++c)
-    {
-      if (matrix(row, c) != 0)
-      {
-        last = c;
-        ++count;
-      }
-    }
-    if (count == 1)
-      return matroid.name2(last);
-
-    /// Check for parallel
-    for (size_t r = 0; r < minor_height; ++r)
-    {
-      bool same = true;
-      for (size_t c = 0; c < minor_width; ++c)
-      {
-        if (matrix(r, c) != matrix(row, c))
-        {
-          same = false;
-          break;
-        }
-      }
-      if (same)
-      {
-        return matroid.name1(r);
-      }
-    }
-
-    throw std::logic_error("find_parallel_to_row did not find any parallel / unit vector!");
-  }
-
-  /**
-   * A filter for a graph which excludes some edges and a given vertex
-   */
-
-  template <typename Graph>
-  struct articulation_edge_filter
-  {
-    typedef typename boost::graph_traits<Graph>::vertex_descriptor vertex_descriptor;
-    typedef typename boost::graph_traits<Graph>::edge_descriptor edge_descriptor;
-    typedef std::set<edge_descriptor> edge_set;
 
     /**
-     * Constructs the filter.
+     * Converts an error of the C library into an exception.
      */
 
-    articulation_edge_filter() :
-      graph_(NULL), articulation_vertex_(NULL), evil_edges_(NULL)
+    inline void check(TU_ERROR error)
     {
+      if (error == TU_ERROR_MEMORY)
+        throw std::bad_alloc();
+      else if (error != TU_OKAY)
+        throw std::runtime_error("Graphicness test of the C library failed.");
     }
 
     /**
-     * Constructs the filter
-     *
-     * @param graph The original graph
-     * @param articulation_vertex The excluded vertex
-     * @param evil_edges The set of excluded edges
+     * Owns a \ref TU environment and the decompositions and graphs created in it.
      */
 
-    articulation_edge_filter(const Graph* graph, const vertex_descriptor* articulation_vertex,
-        const edge_set* evil_edges) :
-      graph_(graph), articulation_vertex_(articulation_vertex), evil_edges_(evil_edges)
+    class graphicness_tester
     {
-    }
-
-    /**
-     * Filter operator
-     *
-     * @param e The edge to be considered
-     * @return true if and only if this edge is included in the filtered graph
-     */
-
-    template <typename Edge>
-    bool operator()(const Edge& e) const
-    {
-      if (evil_edges_->find(e) != evil_edges_->end())
-        return false;
-
-      if (boost::source(e, *graph_) == *articulation_vertex_)
-        return false;
-
-      if (boost::target(e, *graph_) == *articulation_vertex_)
-        return false;
-
-      return true;
-    }
+    public:
+      graphicness_tester() :
+        _tu(NULL), _dec(NULL), _graph(NULL), _forest_edges(NULL), _coforest_edges(NULL)
+      {
+        check(TUcreateEnvironment(&_tu));
+      }
 
-  private:
-    const Graph* graph_;
-    const vertex_descriptor* articulation_vertex_;
-    const edge_set* evil_edges_;
-  };
+      ~graphicness_tester()
+      {
+        clear();
+        TUfreeEnvironment(&_tu);
+      }
 
-  /**
-   * Constructs an articulation edge filter for a given graph.
-   *
-   * @param graph The given graph
-   * @param articulation_vertex Vertex to be excluded
-   * @param evil_edges Edges to be excluded
-   * @return The constructed filter
-   */
+      /**
+       * Tests the top-left submatrix of the given size for graphicness by adding its columns one by one to a graphic
+       * decomposition of the C library. The submatrix is the representation matrix of a minor.
+       *
+       * @param matrix Representation matrix of the given matroid
+       * @param height Number of rows of the submatrix
+       * @param width Number of columns of the submatrix
+       * @param certificate Whether to keep the graph for a later call to create_graph
+       * @param transposed Whether to test the transpose of the given matrix instead
+       * @param cancelled If not NULL and set before all columns are added, then the test stops with false
+       * @return true if and only if the submatrix is graphic
+       */
+
+      template <typename MatrixType>
+      bool test(const MatrixType& matrix, size_t height, size_t width, bool certificate, bool transposed = false,
+          const std::atomic <bool>* cancelled = NULL)
+      {
+        clear();
 
-  template <typename Graph, typename Vertex, typename EdgeSet>
-  inline struct articulation_edge_filter<Graph> make_articulation_edge_filter(const Graph* graph,
-      const Vertex* articulation_vertex, const EdgeSet* evil_edges)
-  {
-    return articulation_edge_filter<Graph> (graph, articulation_vertex, evil_edges);
-  }
+        check(TUgraphicDecCreate(_tu, &_dec, height));
+        std::vector <int> rows;
+        for (size_t column = 0; column < width; ++column)
+        {
+          if (cancelled && *cancelled)
+            return false;
 
-  /**
-   * Tries to extend a 3-connected graph of a graphic minor or detects that
-   * the extended minor is not graphic.
-   *
-   * @param graph The graph of the graphic minor
-   * @param matroid The matroid
-   * @param matrix Representation matrix of the matroid
-   * @param minor_height Number of row elements of the minor
-   * @param minor_width Number of column elements of the minor
-   * @param extension_type Type of the extension
-   * @return true if and only if the extension was possible.
-   */
+          rows.clear();
+          for (size_t row = 0; row < height; ++row)
+          {
+            if ((transposed ? matrix(column, row) : matrix(row, column)) != 0)
+              rows.push_back(row);
+          }
 
-  template <typename MatroidType, typename MatrixType>
-  bool extend_graph(matroid_graph& graph, const MatroidType& matroid, const MatrixType& matrix,
-      const size_t minor_height, const size_t minor_width, const nested_minor_sequence::extension_type extension_type)
-  {
-    typedef boost::graph_traits<matroid_graph> traits;
+          bool is_graphic;
+          check(TUgraphicDecAddColumn(_tu, _dec, rows.empty() ? NULL : &rows[0], rows.size(), true, &is_graphic));
+          if (!is_graphic)
+            return false;
+        }
 
-    matroid_element_map element_map = boost::get(edge_matroid_element, graph);
-    std::map<int, traits::edge_descriptor> reverse_element_map;
+        if (certificate)
+          check(TUgraphicDecGraph(_tu, _dec, &_graph, &_forest_edges, &_coforest_edges));
+        return true;
+      }
 
-    typename traits::edge_iterator edge_iter, edge_end;
-    for (boost::tie(edge_iter, edge_end) = boost::edges(graph); edge_iter != edge_end; ++edge_iter)
-    {
-      reverse_element_map[element_map[*edge_iter]] = *edge_iter;
-    }
+      /**
+       * Converts the graph of the last successful test into a matroid graph whose edges are labeled by the matroid
+       * elements.
+       *
+       * @param matroid The given matroid
+       * @return The constructed graph
+       */
 
-    /// Distinct extension cases
-    switch (extension_type)
-    {
-    case nested_minor_sequence::TWO_ROWS_ONE_COLUMN:
-    {
-      int first_edge_element = find_parallel_to_row(matroid, matrix, minor_height, minor_width, minor_height);
-      int second_edge_element = find_parallel_to_row(matroid, matrix, minor_height, minor_width, minor_height + 1);
+      template <typename MatroidType>
+      matroid_graph* create_graph(const MatroidType& matroid) const
+      {
+        assert(_graph && _forest_edges && _coforest_edges);
 
-      /// Find vertices of corresponding edges
+        std::vector <int> vertex(TUgraphMemNodes(_graph), -1);
+        int num_vertices = 0;
+        for (TU_GRAPH_NODE v = TUgraphNodesFirst(_graph); TUgraphNodesValid(_graph, v); v = TUgraphNodesNext(_graph, v))
+          vertex[v] = num_vertices++;
 
-      traits::vertex_descriptor first_vertex1 = boost::source(reverse_element_map[first_edge_element], graph);
-      traits::vertex_descriptor first_vertex2 = boost::target(reverse_element_map[first_edge_element], graph);
-      traits::vertex_descriptor second_vertex1 = boost::source(reverse_element_map[second_edge_element], graph);
-      traits::vertex_descriptor second_vertex2 = boost::target(reverse_element_map[second_edge_element], graph);
+        matroid_graph* graph = new matroid_graph(num_vertices);
+        for (size_t row = 0; row < matroid.size1(); ++row)
+        {
+          TU_GRAPH_EDGE e = _forest_edges[row];
+          boost::add_edge(vertex[TUgraphEdgeU(_graph, e)], vertex[TUgraphEdgeV(_graph, e)], matroid.name1(row), *graph);
+        }
+        for (size_t column = 0; column < matroid.size2(); ++column)
+        {
+          TU_GRAPH_EDGE e = _coforest_edges[column];
+          boost::add_edge(vertex[TUgraphEdgeU(_graph, e)], vertex[TUgraphEdgeV(_graph, e)], matroid.name2(column),
+              *graph);
+        }
+        return graph;
+      }
 
-      if (first_vertex1 == second_vertex2)
-        std::swap(second_vertex1, second_vertex2);
-      if (first_vertex2 == second_vertex1)
-        std::swap(first_vertex1, first_vertex2);
-      if (first_vertex2 == second_vertex2)
+    private:
+      void clear()
       {
-        std::swap(first_vertex1, first_vertex2);
-        std::swap(second_vertex1, second_vertex2);
+        if (_coforest_edges)
+          TUfreeBlockArray(_tu, &_coforest_edges);
+        if (_forest_edges)
+          TUfreeBlockArray(_tu, &_forest_edges);
+        if (_graph)
+          TUgraphFree(_tu, &_graph);
+        if (_dec)
+          TUgraphicDecFree(_tu, &_dec);
       }
-      if (first_vertex1 != second_vertex1)
-        return false;
-
-      /// Remove old edges
 
-      boost::remove_edge(reverse_element_map[first_edge_element], graph);
-      boost::remove_edge(reverse_element_map[second_edge_element], graph);
+      TU* _tu;
+      TU_GRAPHIC_DEC* _dec;
+      TU_GRAPH* _graph;
+      TU_GRAPH_EDGE* _forest_edges;
+      TU_GRAPH_EDGE* _coforest_edges;
+    };
 
-      /// Create new vertices
-
-      traits::vertex_descriptor first_breaker = boost::add_vertex(graph);
-      traits::vertex_descriptor second_breaker = boost::add_vertex(graph);
-
-      /// Create new edges
-
-      boost::add_edge(first_vertex2, first_breaker, first_edge_element, graph);
-      boost::add_edge(first_breaker, first_vertex1, matroid.name1(minor_height), graph);
-      boost::add_edge(second_vertex2, second_breaker, second_edge_element, graph);
-      boost::add_edge(second_breaker, second_vertex1, matroid.name1(minor_height + 1), graph);
-      boost::add_edge(first_breaker, second_breaker, matroid.name2(minor_width), graph);
+    /**
+     * Tracks the graphicness of a growing sequence of nested minors, where the i-th minor is the top-left
+     * heights[i] x widths[i] submatrix, or its transpose to track cographicness. While the minors only grow by
+     * columns, the largest one is kept in an incremental graphic decomposition of the C library, such that checking
+     * and appending a column takes almost linear time in its nonzeros. The decomposition cannot add rows, so the
+     * first extension with new rows drops it and the tracker becomes outdated. The next \ref update then tests the
+     * largest minor once and, if it is not graphic, finds the largest graphic one by binary search. Graphicness is
+     * closed under taking minors, so once a minor is not graphic, no further work is done.
+     */
 
-      return true;
-    }
-    break;
-    case nested_minor_sequence::ONE_ROW_TWO_COLUMNS:
+    class minor_sequence_graphicness
     {
-      int first_edge_element = find_parallel_to_row(make_transposed_matroid(matroid), make_transposed_matrix(matrix),
-          minor_width, minor_height, minor_width);
-      int second_edge_element = find_parallel_to_row(make_transposed_matroid(matroid), make_transposed_matrix(matrix),
-          minor_width, minor_height, minor_width + 1);
-
-      /// Find vertices of corresponding edges
-
-      traits::vertex_descriptor first_vertex1 = boost::source(reverse_element_map[first_edge_element], graph);
-      traits::vertex_descriptor first_vertex2 = boost::target(reverse_element_map[first_edge_element], graph);
-      traits::vertex_descriptor second_vertex1 = boost::source(reverse_element_map[second_edge_element], graph);
-      traits::vertex_descriptor second_vertex2 = boost::target(reverse_element_map[second_edge_element], graph);
-
-      if (first_vertex1 == second_vertex2)
-        std::swap(second_vertex1, second_vertex2);
-      if (first_vertex2 == second_vertex1)
-        std::swap(first_vertex1, first_vertex2);
-      if (first_vertex2 == second_vertex2)
+    public:
+      minor_sequence_graphicness(TU* tu, bool transposed) :
+        _tu(tu), _transposed(transposed), _dec(NULL), _height(0), _width(0), _num_extensions(0), _is_graphic(true),
+        _is_outdated(false)
       {
-        std::swap(first_vertex1, first_vertex2);
-        std::swap(second_vertex1, second_vertex2);
-      }
-      if (first_vertex1 != second_vertex1)
-        return false;
-
-      /// Create new vertex
-
-      traits::vertex_descriptor additional_vertex = boost::add_vertex(graph);
-
-      /// Create new edges
 
-      boost::add_edge(first_vertex2, additional_vertex, matroid.name2(minor_width), graph);
-      boost::add_edge(second_vertex2, additional_vertex, matroid.name2(minor_width + 1), graph);
-      boost::add_edge(first_vertex1, additional_vertex, matroid.name1(minor_height), graph);
+      }
 
-      return true;
-    }
-    break;
-    case nested_minor_sequence::ONE_ROW_ONE_COLUMN:
-    {
-      int row_edge_element = find_parallel_to_row(matroid, matrix, minor_height, minor_width, minor_height);
-      int column_edge_element = find_parallel_to_row(make_transposed_matroid(matroid), make_transposed_matrix(matrix),
-          minor_width, minor_height, minor_width);
-
-      /// Find vertices of corresponding edges
-
-      traits::vertex_descriptor row_vertex1 = boost::source(reverse_element_map[row_edge_element], graph);
-      traits::vertex_descriptor row_vertex2 = boost::target(reverse_element_map[row_edge_element], graph);
-      traits::vertex_descriptor column_vertex1 = boost::source(reverse_element_map[column_edge_element], graph);
-      traits::vertex_descriptor column_vertex2 = boost::target(reverse_element_map[column_edge_element], graph);
-
-      if (row_vertex1 == column_vertex2)
-        std::swap(column_vertex1, column_vertex2);
-      if (row_vertex2 == column_vertex1)
-        std::swap(row_vertex1, row_vertex2);
-      if (row_vertex2 == column_vertex2)
+      ~minor_sequence_graphicness()
       {
-        std::swap(row_vertex1, row_vertex2);
-        std::swap(column_vertex1, column_vertex2);
+        clear();
       }
-      if (row_vertex1 != column_vertex1)
-        return false;
-
-      /// Remove old edges
-
-      boost::remove_edge(reverse_element_map[row_edge_element], graph);
 
-      /// Create new vertex
+      /**
+       * @return true if and only if the largest minor seen so far is graphic. If the tracker is outdated, this is
+       *         only known for the minor after \ref largest_graphic_minor extensions.
+       */
 
-      traits::vertex_descriptor row_breaker = boost::add_vertex(graph);
-
-      /// Create new edges
-
-      boost::add_edge(row_vertex2, row_breaker, row_edge_element, graph);
-      boost::add_edge(row_breaker, row_vertex1, matroid.name1(minor_height), graph);
-      boost::add_edge(row_breaker, column_vertex2, matroid.name2(minor_width), graph);
-
-      return true;
-    }
-    break;
-    case nested_minor_sequence::ONE_COLUMN:
-    {
-      typedef std::set<traits::edge_descriptor> edge_set_t;
-      typedef boost::filtered_graph<matroid_graph, boost::is_in_subset<edge_set_t> > edge_subset_graph_t;
-
-      edge_set_t edge_set;
-
-      for (size_t r = 0; r < minor_height; ++r)
+      bool is_graphic() const
       {
-        if (matrix(r, minor_width) == 1)
-          edge_set.insert(reverse_element_map[matroid.name1(r)]);
+        return _is_graphic;
       }
 
-      /// Check if edges form a path
-      std::vector<traits::vertex_descriptor> path;
+      /**
+       * @return true if and only if the largest minor seen so far is known to be graphic and kept in a decomposition
+       */
 
-      edge_subset_graph_t edge_subset_graph(graph, boost::is_in_subset<edge_set_t>(edge_set));
-      if (!tu::util::is_path(edge_subset_graph, boost::get(boost::vertex_index, edge_subset_graph), path))
+      bool is_tracked() const
       {
-        return false;
+        return _is_graphic && !_is_outdated;
       }
 
-      boost::add_edge(path[0], path[path.size() - 1], matroid.name2(minor_width), graph);
-      return true;
-    }
-    break;
-    case nested_minor_sequence::ONE_ROW:
-    {
-      typedef traits::edge_descriptor edge_t;
-      typedef traits::vertex_descriptor vertex_t;
-      typedef std::set<vertex_t> vertex_set;
-      typedef std::set<edge_t> edge_set;
-      typedef std::vector<vertex_t> vertex_vector_t;
-      typedef std::vector<edge_t> edge_vector_t;
+      /**
+       * @return true if and only if minors were appended after the last one known to be graphic without testing them
+       */
 
-      typedef boost::vec_adj_list_vertex_id_map<boost::no_property, traits::vertices_size_type> IndexMap;
-      IndexMap index_map = boost::get(boost::vertex_index, graph);
+      bool is_outdated() const
+      {
+        return _is_outdated;
+      }
 
-      /// Collect all 1-edges
+      /**
+       * @return Number of extensions of the largest minor known to be graphic
+       */
 
-      edge_set one_edges;
-      for (size_t c = 0; c < minor_width; ++c)
+      size_t largest_graphic_minor() const
       {
-        if (matrix(minor_height, c) != 0)
-          one_edges.insert(reverse_element_map[matroid.name2(c)]);
+        return _num_extensions;
       }
 
-      traits::vertex_descriptor the_vertex = traits::null_vertex();
-      if (tu::util::find_star_vertex(boost::make_filtered_graph(graph, boost::is_in_subset<edge_set>(one_edges)),
-          the_vertex))
+      /**
+       * Recomputes the state for the largest of the given minors after its representation matrix has changed, e.g.,
+       * by pivoting, or after the tracker became outdated. The minors up to the largest one known to be graphic must
+       * still be the same.
+       *
+       * @param matrix Representation matrix of the matroid
+       * @param heights Numbers of rows of the minors
+       * @param widths Numbers of columns of the minors
+       */
+
+      template <typename MatrixType>
+      void update(const MatrixType& matrix, const std::vector <size_t>& heights, const std::vector <size_t>& widths)
       {
-        /// Create the new vertex and connect it with the_vertex.
+        if (!_is_graphic)
+          return;
 
-        traits::vertex_descriptor new_vertex = boost::add_vertex(graph);
-        boost::add_edge(the_vertex, new_vertex, matroid.name1(minor_height), graph);
+        size_t last = heights.size() - 1;
+        clear();
+        _is_outdated = false;
+        if (build(matrix, heights[last], widths[last]))
+        {
+          _num_extensions = last;
+          return;
+        }
 
-        /// Reconnect the 1-edges
+        clear();
+        _is_graphic = false;
 
-        for (edge_set::const_iterator edge_iter = one_edges.begin(); edge_iter != one_edges.end(); ++edge_iter)
+        /// The largest graphic minor lies between the one known to be graphic and the last one.
+        graphicness_tester tester;
+        size_t lower = _num_extensions;
+        size_t upper = last;
+        while (upper - lower > 1)
         {
-          traits::edge_descriptor edge = *edge_iter;
-          traits::vertex_descriptor other_vertex = boost::source(edge, graph);
-          if (other_vertex == the_vertex)
-            other_vertex = boost::target(edge, graph);
-          int name = element_map[edge];
-          boost::remove_edge(the_vertex, other_vertex, graph);
-          boost::add_edge(new_vertex, other_vertex, name, graph);
+          size_t middle = (lower + upper) / 2;
+          if (tester.test(matrix, heights[middle], widths[middle], false, _transposed))
+            lower = middle;
+          else
+            upper = middle;
         }
-
-        return true;
+        _num_extensions = lower;
       }
 
-      /// Count for each vertex the number of paths that use it
-
-      std::vector<size_t> common_vertex_count(boost::num_vertices(graph), 0);
-      for (size_t c = 0; c < minor_width; ++c)
+      /**
+       * Appends the rows and columns of the next minor, which has the given size. New columns are tested right
+       * away, while new rows make the tracker outdated until the next \ref update.
+       *
+       * @param matrix Representation matrix of the matroid
+       * @param height Number of rows of the next minor
+       * @param width Number of columns of the next minor
+       */
+
+      template <typename MatrixType>
+      void extend(const MatrixType& matrix, size_t height, size_t width)
       {
-        if (matrix(minor_height, c) == 0)
-          continue;
+        if (!_is_graphic || _is_outdated)
+          return;
 
-        edge_set edges;
-        for (size_t r = 0; r < minor_height; ++r)
+        if (height > _height)
         {
-          if (matrix(r, c) == 1)
-            edges.insert(reverse_element_map[matroid.name1(r)]);
+          /// The decomposition cannot add rows, and rebuilding it for every such extension costs quadratic time.
+          clear();
+          _is_outdated = true;
+          return;
         }
 
-        vertex_set vertices;
-        tu::util::used_vertices(boost::make_filtered_graph(graph, boost::is_in_subset<edge_set>(edges)), vertices);
+        bool is_graphic = true;
+        for (; _width < width && is_graphic; ++_width)
+          is_graphic = add_column(matrix, _width, true);
 
-        for (typename vertex_set::const_iterator iter = vertices.begin(); iter != vertices.end(); ++iter)
+        if (is_graphic)
+          ++_num_extensions;
+        else
         {
-          common_vertex_count[boost::get(index_map, *iter)]++;
+          clear();
+          _is_graphic = false;
         }
       }
 
-      /// Find articulation points for the graph without 1-edges
+      /**
+       * Checks whether appending the given column to the largest minor, which must be tracked, destroys graphicness.
+       *
+       * @param matrix Representation matrix of the matroid
+       * @param column Index of a column outside the largest minor
+       * @return true if and only if the minor with this column is not graphic
+       */
 
-      vertex_vector_t articulation_points;
-      boost::articulation_points(boost::make_filtered_graph(graph, boost::is_not_in_subset<edge_set>(one_edges)),
-          std::back_inserter(articulation_points));
+      template <typename MatrixType>
+      bool breaks(const MatrixType& matrix, size_t column)
+      {
+        assert(is_tracked());
+
+        return !add_column(matrix, column, false);
+      }
+
+    private:
+      template <typename MatrixType>
+      long long entry(const MatrixType& matrix, size_t row, size_t column) const
+      {
+        return _transposed ? matrix(column, row) : matrix(row, column);
+      }
 
-      std::vector<traits::vertex_descriptor> the_vertex_candidates;
-      the_vertex = traits::null_vertex();
-      for (vertex_vector_t::const_iterator iter = articulation_points.begin(); iter != articulation_points.end();
-          ++iter)
+      template <typename MatrixType>
+      bool add_column(const MatrixType& matrix, size_t column, bool apply)
       {
-        if (common_vertex_count[boost::get(index_map, *iter)] == one_edges.size())
+        _indices.clear();
+        for (size_t row = 0; row < _height; ++row)
         {
-          the_vertex_candidates.push_back(*iter);
+          if (entry(matrix, row, column) != 0)
+            _indices.push_back(row);
         }
+
+        bool is_graphic;
+        check(TUgraphicDecAddColumn(_tu, _dec, _indices.empty() ? NULL : &_indices[0], _indices.size(), apply,
+            &is_graphic));
+        return is_graphic;
       }
 
-      if (the_vertex_candidates.empty() || the_vertex_candidates.size() > 2)
-        return false;
+      template <typename MatrixType>
+      bool build(const MatrixType& matrix, size_t height, size_t width)
+      {
+        check(TUgraphicDecCreate(_tu, &_dec, height));
+        _height = height;
+        _width = 0;
+        for (; _width < width; ++_width)
+        {
+          if (!add_column(matrix, _width, true))
+            return false;
+        }
+        return true;
+      }
 
-      for (vertex_vector_t::const_iterator iter = the_vertex_candidates.begin(); iter != the_vertex_candidates.end();
-          ++iter)
+      void clear()
       {
-        the_vertex = *iter;
+        if (_dec)
+          TUgraphicDecFree(_tu, &_dec);
+      }
 
-        /// Filter the chosen articulation point and the one-edges and check the remaining graph
+      TU* _tu;
+      bool _transposed;
+      TU_GRAPHIC_DEC* _dec;
+      size_t _height;
+      size_t _width;
+      size_t _num_extensions;
+      bool _is_graphic;
+      bool _is_outdated;
+      std::vector <int> _indices;
+    };
 
-        vertex_set articulation_set;
-        articulation_set.insert(the_vertex);
-        std::vector<size_t> component_vector(boost::num_vertices(graph));
+    /**
+     * Tracks graphicness and cographicness of a growing sequence of nested minors of a matroid.
+     */
 
-        size_t num_components = boost::connected_components(
-            boost::make_filtered_graph(graph, make_articulation_edge_filter(&graph, &the_vertex, &one_edges),
-                boost::is_not_in_subset<vertex_set>(articulation_set)),
-            boost::make_iterator_property_map(component_vector.begin(), index_map));
+    class nested_minor_graphicness
+    {
+    public:
+      nested_minor_graphicness() :
+        _graph(_environment.tu, false), _cograph(_environment.tu, true)
+      {
 
-        /// We should really have articulation point + 2 further components
-        assert(num_components >= 2);
+      }
 
-        typedef boost::adjacency_list<boost::vecS, boost::vecS, boost::undirectedS> component_graph_t;
-        component_graph_t component_graph(num_components);
+      /**
+       * @return true if and only if the largest minor seen so far is known to be graphic
+       */
 
-        bool abort = false;
-        for (typename edge_set::const_iterator iter = one_edges.begin(); iter != one_edges.end(); ++iter)
-        {
-          typename boost::graph_traits<component_graph_t>::vertex_descriptor source, target;
-          source = boost::source(*iter, graph);
-          target = boost::target(*iter, graph);
-          if (source == the_vertex || target == the_vertex)
-            continue;
+      bool is_graphic() const
+      {
+        return _graph.is_tracked();
+      }
 
-          size_t source_component = component_vector[boost::get(index_map, source)];
-          size_t target_component = component_vector[boost::get(index_map, target)];
+      /**
+       * @return true if and only if the largest minor seen so far is known to be cographic
+       */
 
-          if (source_component == target_component)
-          {
-            /// There cannot be a 1-edge inside one component.
-            abort = true;
-            break;
-          }
+      bool is_cographic() const
+      {
+        return _cograph.is_tracked();
+      }
 
-          boost::add_edge(boost::vertex(source_component, component_graph),
-              boost::vertex(target_component, component_graph), component_graph);
-        }
+      /**
+       * @return Number of extensions of the largest graphic minor
+       */
 
-        if (abort)
-          continue;
+      size_t largest_graphic_minor() const
+      {
+        return _graph.largest_graphic_minor();
+      }
 
-        boost::one_bit_color_map<boost::vec_adj_list_vertex_id_map<boost::no_property, traits::vertices_size_type> > bipartition(
-            num_components, boost::get(boost::vertex_index, component_graph));
+      /**
+       * @return Number of extensions of the largest cographic minor
+       */
 
-        if (!boost::is_bipartite(component_graph, boost::get(boost::vertex_index, component_graph), bipartition))
-        {
-          continue;
-        }
+      size_t largest_cographic_minor() const
+      {
+        return _cograph.largest_graphic_minor();
+      }
+
+      /**
+       * Recomputes the state for the largest minor of the given sequence, e.g., after its representation matrix has
+       * changed or if the sequence was constructed without tracking.
+       *
+       * @param matrix Representation matrix of the matroid
+       * @param nested_minors Sequence of nested minors
+       */
 
-        for (size_t i = 0; i < component_vector.size(); ++i)
+      template <typename MatrixType, typename NestedMinorSequenceType>
+      void update(const MatrixType& matrix, const NestedMinorSequenceType& nested_minors)
+      {
+        std::vector <size_t> heights(nested_minors.size() + 1, 3);
+        std::vector <size_t> widths(nested_minors.size() + 1, 3);
+        for (size_t i = 0; i < nested_minors.size(); ++i)
         {
-          if (boost::vertex(i, graph) == the_vertex)
-            continue;
+          heights[i + 1] = heights[i] + nested_minors.get_extension_height(i);
+          widths[i + 1] = widths[i] + nested_minors.get_extension_width(i);
         }
 
-        vertex_t new_vertex = boost::add_vertex(graph);
+        _graph.update(matrix, heights, widths);
+        _cograph.update(matrix, widths, heights);
+      }
 
-        edge_vector_t reconnect_edges;
-        typename traits::out_edge_iterator out_edge_iter, out_edge_end;
-        for (boost::tie(out_edge_iter, out_edge_end) = boost::incident_edges(the_vertex, graph);
-            out_edge_iter != out_edge_end; ++out_edge_iter)
-        {
-          vertex_t incident_vertex = boost::target(*out_edge_iter, graph);
+      /**
+       * Tests the minors that were appended without testing them, such that \ref largest_graphic_minor and
+       * \ref largest_cographic_minor are exact.
+       *
+       * @param matrix Representation matrix of the matroid
+       * @param nested_minors Sequence of nested minors
+       */
 
-          bool reconnect = boost::get(bipartition,
-              boost::vertex(component_vector[boost::get(index_map, incident_vertex)], component_graph))
-              != boost::one_bit_white;
+      template <typename MatrixType, typename NestedMinorSequenceType>
+      void complete(const MatrixType& matrix, const NestedMinorSequenceType& nested_minors)
+      {
+        if (_graph.is_outdated() || _cograph.is_outdated())
+          update(matrix, nested_minors);
+      }
 
-          if (one_edges.find(*out_edge_iter) != one_edges.end())
-            reconnect = !reconnect;
+      /**
+       * Appends the last extension of the given sequence.
+       *
+       * @param matrix Representation matrix of the matroid
+       * @param nested_minors Sequence of nested minors
+       */
+
+      template <typename MatrixType, typename NestedMinorSequenceType>
+      void extend(const MatrixType& matrix, const NestedMinorSequenceType& nested_minors)
+      {
+        _graph.extend(matrix, nested_minors.height(), nested_minors.width());
+        _cograph.extend(matrix, nested_minors.width(), nested_minors.height());
+      }
+
+      /**
+       * Checks whether a row extension would make the largest minor non-cographic. If the largest minor is not
+       * known to be cographic, this is never the case.
+       *
+       * @param matrix Representation matrix of the matroid
+       * @param row Index of a row outside the largest minor
+       */
+
+      template <typename MatrixType>
+      bool row_breaks_cographicness(const MatrixType& matrix, size_t row)
+      {
+        return _cograph.is_tracked() && _cograph.breaks(matrix, row);
+      }
+
+      /**
+       * Checks whether a column extension would make the largest minor non-graphic. If the largest minor is not
+       * known to be graphic, this is never the case.
+       *
+       * @param matrix Representation matrix of the matroid
+       * @param column Index of a column outside the largest minor
+       */
+
+      template <typename MatrixType>
+      bool column_breaks_graphicness(const MatrixType& matrix, size_t column)
+      {
+        return _graph.is_tracked() && _graph.breaks(matrix, column);
+      }
 
-          if (reconnect)
-            reconnect_edges.push_back(*out_edge_iter);
+    private:
+      /// Owns the \ref TU environment, which must outlive the decompositions created in it.
+      struct environment
+      {
+        environment() :
+          tu(NULL)
+        {
+          check(TUcreateEnvironment(&tu));
         }
 
-        for (typename edge_vector_t::const_iterator iter = reconnect_edges.begin(); iter != reconnect_edges.end();
-            ++iter)
+        ~environment()
         {
-          util::reconnect_edge(graph, *iter, the_vertex, new_vertex);
+          TUfreeEnvironment(&tu);
         }
 
-        boost::add_edge(the_vertex, new_vertex, matroid.name1(minor_height), graph);
+        TU* tu;
+      };
 
-        return true;
-      }
+      environment _environment;
+      minor_sequence_graphicness _graph;
+      minor_sequence_graphicness _cograph;
+    };
 
-      return false;
-    }
-    break;
-    default:
-      throw std::logic_error("Unknown extension in graphicness test.");
-    }
-  }
+  } /* namespace detail */
 
   /**
-   * Either constructs a graph whose forest matroid is the given matroid or detects
-   * that the given matroid is non-graphic.
+   * Either constructs a graph whose forest matroid is the given matroid or detects that the given matroid is
+   * non-graphic.
    *
    * @param matroid The given matroid
    * @param matrix Representation matrix of the given matroid
-   * @param nested_minors Sequence of nested minors
-   * @return The constructed graph or NULL if the matroid is not graphic.
+   * @param construct_graph Whether to construct the graph if the matroid is graphic
+   * @param is_graphic Returns whether the matroid is graphic
+   * @param cancelled If not NULL and set, then the test stops with is_graphic = false
+   * @return The constructed graph or NULL if the matroid is not graphic or no graph was requested.
    */
 
-  template <typename MatroidType, typename MatrixType, typename NestedMinorSequenceType>
-  matroid_graph* construct_matroid_graph(const MatroidType& matroid, const MatrixType& matrix,
-      const NestedMinorSequenceType& nested_minors, size_t& largest_graphic_minor)
+  template <typename MatroidType, typename MatrixType>
+  matroid_graph* construct_matroid_graph(const MatroidType& matroid, const MatrixType& matrix, bool construct_graph,
+      bool& is_graphic, const std::atomic <bool>* cancelled = NULL)
   {
-    typedef boost::graph_traits<matroid_graph>::vertex_descriptor vertex_descriptor;
-
-    /// Initialize W3
-
-    largest_graphic_minor = 0;
-    matroid_graph* graph = new matroid_graph(4);
-
-    vertex_descriptor center_vertex = boost::vertex(0, *graph);
-    vertex_descriptor border_vertex1 = boost::vertex(1, *graph);
-    vertex_descriptor border_vertex2 = boost::vertex(2, *graph);
-    vertex_descriptor border_vertex3 = boost::vertex(3, *graph);
-
-    boost::add_edge(center_vertex, border_vertex1, matroid.name1(0), *graph).first;
-    boost::add_edge(center_vertex, border_vertex2, matroid.name1(1), *graph).first;
-    boost::add_edge(center_vertex, border_vertex3, matroid.name2(2), *graph).first;
-    boost::add_edge(border_vertex1, border_vertex2, matroid.name2(0), *graph).first;
-    boost::add_edge(border_vertex1, border_vertex3, matroid.name2(1), *graph).first;
-    boost::add_edge(border_vertex2, border_vertex3, matroid.name1(2), *graph).first;
-
-    size_t minor_height = 3;
-    size_t minor_width = 3;
-
-    for (size_t i = 0; i < nested_minors.size(); ++i)
-    {
-      if (!extend_graph(*graph, matroid, matrix, minor_height, minor_width, nested_minors.get_extension(i)))
-      {
-        delete graph;
-        return NULL;
-      }
-
-      minor_height += nested_minors.get_extension_height(i);
-      minor_width += nested_minors.get_extension_width(i);
-      largest_graphic_minor++;
-    }
-
-    return graph;
+    is_graphic = false;
+    if (cancelled && *cancelled)
+      return NULL;
+
+    detail::graphicness_tester tester;
+    is_graphic = tester.test(matrix, matrix.size1(), matrix.size2(), construct_graph, false, cancelled);
+    if (is_graphic && construct_graph)
+      return tester.create_graph(matroid);
+    else
+      return NULL;
   }
 
 } /* namespace tu */
@@ -1295,7 +1295,7 @@ bool TUisBinaryDbl(TU* tu, TU_DBLMAT* sparse, double epsilon, TU_SUBMAT** submat
     for (int entry = begin; entry < end; ++entry)
     {
       double value = sparse->entryValues[entry];
-      int rounded = (int)(value + 0.5);
+      int rounded = (int) round(value);
       if (rounded < 0 || rounded > +1 || fabs(value - rounded) > epsilon)
       {
         if (submatrix)
@@ -1365,7 +1365,7 @@ bool TUisTernaryDbl(TU* tu, TU_DBLMAT* sparse, double epsilon, TU_SUBMAT** subma
     for (int entry = begin; entry < end; ++entry)
     {
       double value = sparse->entryValues[entry];
-      int rounded = (int)(value + 0.5);
+      int rounded = (int) round(value);
       if (rounded < -1 || rounded > +1 || fabs(value - rounded) > epsilon)
       {
         if (submatrix)
@@ -0,0 +1,559 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <boost/numeric/ublas/matrix.hpp>
+#include <boost/numeric/ublas/matrix_expression.hpp>
+#include <boost/numeric/ublas/detail/iterator.hpp>
+
+#include <tu/matrix_transposed.hpp>
+#include <tu/matrix_permuted.hpp>
+#include "matroid.hpp"
+#include "matroid_transposed.hpp"
+#include "matroid_permuted.hpp"
+
+namespace tu
+{
+
+  template <typename MatroidType>
+  class matroid_summand;
+
+  template <typename MatrixType>
+  class matrix_summand;
+
+  namespace detail
+  {
+
+    /**
+     * Locates rows and columns of a matroid or matrix in the storage it is based on. A negative source indicates
+     * that the row or column is not part of that storage.
+     */
+
+    template <typename Type>
+    struct summand_traits
+    {
+      typedef Type root_type;
+
+      static root_type& root(Type& data)
+      {
+        return data;
+      }
+
+      static std::ptrdiff_t source1(Type& data, size_t index)
+      {
+        return index;
+      }
+
+      static std::ptrdiff_t source2(Type& data, size_t index)
+      {
+        return index;
+      }
+    };
+
+    template <typename MatroidType>
+    struct summand_traits <matroid_summand <MatroidType> >
+    {
+      typedef MatroidType root_type;
+
+      static root_type& root(matroid_summand <MatroidType>& data)
+      {
+        return data.root();
+      }
+
+      static std::ptrdiff_t source1(matroid_summand <MatroidType>& data, size_t index)
+      {
+        return data.source1(index);
+      }
+
+      static std::ptrdiff_t source2(matroid_summand <MatroidType>& data, size_t index)
+      {
+        return data.source2(index);
+      }
+    };
+
+    template <typename MatrixType>
+    struct summand_traits <matrix_summand <MatrixType> >
+    {
+      typedef MatrixType root_type;
+
+      static root_type& root(matrix_summand <MatrixType>& data)
+      {
+        return data.root();
+      }
+
+      static std::ptrdiff_t source1(matrix_summand <MatrixType>& data, size_t index)
+      {
+        return data.source1(index);
+      }
+
+      static std::ptrdiff_t source2(matrix_summand <MatrixType>& data, size_t index)
+      {
+        return data.source2(index);
+      }
+    };
+
+    template <typename MatroidType>
+    struct summand_traits <matroid_permuted <MatroidType> >
+    {
+      typedef typename summand_traits <MatroidType>::root_type root_type;
+
+      static root_type& root(matroid_permuted <MatroidType>& data)
+      {
+        return summand_traits <MatroidType>::root(data.data());
+      }
+
+      static std::ptrdiff_t source1(matroid_permuted <MatroidType>& data, size_t index)
+      {
+        return summand_traits <MatroidType>::source1(data.data(), data.perm1()(index));
+      }
+
+      static std::ptrdiff_t source2(matroid_permuted <MatroidType>& data, size_t index)
+      {
+        return summand_traits <MatroidType>::source2(data.data(), data.perm2()(index));
+      }
+    };
+
+    template <typename MatrixType>
+    struct summand_traits <matrix_permuted <MatrixType> >
+    {
+      typedef typename summand_traits <MatrixType>::root_type root_type;
+
+      static root_type& root(matrix_permuted <MatrixType>& data)
+      {
+        return summand_traits <MatrixType>::root(data.data());
+      }
+
+      static std::ptrdiff_t source1(matrix_permuted <MatrixType>& data, size_t index)
+      {
+        return summand_traits <MatrixType>::source1(data.data(), data.perm1()(index));
+      }
+
+      static std::ptrdiff_t source2(matrix_permuted <MatrixType>& data, size_t index)
+      {
+        return summand_traits <MatrixType>::source2(data.data(), data.perm2()(index));
+      }
+    };
+
+    /**
+     * Maps the rows or columns of a summand to sources in the root storage. Marker rows and columns as well as those
+     * which the parent does not take from the root storage get negative sources -1 - k, where k is their position in
+     * the summand's own buffer.
+     *
+     * @param parent The separated matroid or matrix
+     * @param rows true for rows and false for columns
+     * @param indices Parent indices of the summand's rows or columns
+     * @param markers Flags indicating the marker rows or columns
+     * @param sources Returns the sources of the summand's rows or columns
+     * @return Number of buffered rows or columns
+     */
+
+    template <typename ParentType>
+    size_t map_summand_sources(ParentType& parent, bool rows, const std::vector <size_t>& indices,
+        const std::vector <bool>& markers, std::vector <std::ptrdiff_t>& sources)
+    {
+      size_t num_buffered = 0;
+      sources.resize(indices.size());
+      for (size_t i = 0; i < indices.size(); ++i)
+      {
+        std::ptrdiff_t source = rows ? summand_traits <ParentType>::source1(parent, indices[i])
+            : summand_traits <ParentType>::source2(parent, indices[i]);
+        if (markers[i] || source < 0)
+          sources[i] = -1 - std::ptrdiff_t(num_buffered++);
+        else
+          sources[i] = source;
+      }
+      return num_buffered;
+    }
+
+  } /* namespace detail */
+
+  /**
+   * Rows or columns of a summand of a separation, given by the indices of the matroid they are taken from. Markers
+   * are rows or columns which the summand shares with the other summand.
+   */
+
+  class summand_indices
+  {
+  public:
+
+    /**
+     * Adds a row or column.
+     *
+     * @param index Index in the separated matroid
+     * @param marker true if and only if it is shared with the other summand
+     */
+
+    void add(size_t index, bool marker = false)
+    {
+      _indices.push_back(index);
+      _markers.push_back(marker);
+    }
+
+    /**
+     * Adds a range of rows or columns which are not shared with the other summand.
+     *
+     * @param first First index
+     * @param beyond Index beyond the last one
+     */
+
+    void add_range(size_t first, size_t beyond)
+    {
+      for (size_t index = first; index < beyond; ++index)
+        add(index);
+    }
+
+    /**
+     * @return Indices in the separated matroid
+     */
+
+    const std::vector <size_t>& indices() const
+    {
+      return _indices;
+    }
+
+    /**
+     * @return Marker flags
+     */
+
+    const std::vector <bool>& markers() const
+    {
+      return _markers;
+    }
+
+  private:
+    std::vector <size_t> _indices;
+    std::vector <bool> _markers;
+  };
+
+  /**
+   * A summand of a separated matroid which refers to the names of the original matroid. Only marker rows and
+   * columns, which the summand shares with the other one, have their names in a buffer, such that pivots in one
+   * summand do not affect the other.
+   */
+
+  template <typename MatroidType>
+  class matroid_summand
+  {
+  public:
+    typedef MatroidType matroid_type;
+    typedef typename MatroidType::size_type size_type;
+    typedef typename MatroidType::name_type name_type;
+    typedef name_type& reference_type;
+    typedef const name_type& const_reference_type;
+    typedef matroid_summand <MatroidType> self_type;
+
+    /**
+     * Constructs an empty summand.
+     */
+
+    matroid_summand() :
+      _root(NULL)
+    {
+
+    }
+
+    /**
+     * Refers to the given rows and columns of a matroid.
+     *
+     * @param parent The separated matroid, which must be based on MatroidType
+     * @param rows Rows of the summand
+     * @param columns Columns of the summand
+     */
+
+    template <typename ParentType>
+    void assign(ParentType& parent, const summand_indices& rows, const summand_indices& columns)
+    {
+      _root = &detail::summand_traits <ParentType>::root(parent);
+      _names1.resize(detail::map_summand_sources(parent, true, rows.indices(), rows.markers(), _sources1));
+      _names2.resize(detail::map_summand_sources(parent, false, columns.indices(), columns.markers(), _sources2));
+
+      for (size_t row = 0; row < _sources1.size(); ++row)
+      {
+        if (_sources1[row] < 0)
+          _names1[-1 - _sources1[row]] = parent.name1(rows.indices()[row]);
+      }
+      for (size_t column = 0; column < _sources2.size(); ++column)
+      {
+        if (_sources2[column] < 0)
+          _names2[-1 - _sources2[column]] = parent.name2(columns.indices()[column]);
+      }
+    }
+
+    /**
+     * @return Height, i.e. size of each base
+     */
+
+    inline size_type size1() const
+    {
+      return _sources1.size();
+    }
+
+    /**
+     * @return Width, i.e. size of each cobase
+     */
+
+    inline size_type size2() const
+    {
+      return _sources2.size();
+    }
+
+    /**
+     * @param index A row index
+     * @return The corresponding matroid element
+     */
+
+    inline reference_type name1(size_type index)
+    {
+      return _sources1[index] < 0 ? _names1[-1 - _sources1[index]] : _root->name1(_sources1[index]);
+    }
+
+    /**
+     * @param index A row index
+     * @return The corresponding matroid element
+     */
+
+    inline const_reference_type name1(size_type index) const
+    {
+      return _sources1[index] < 0 ? _names1[-1 - _sources1[index]] : _root->name1(_sources1[index]);
+    }
+
+    /**
+     * @param index A column index
+     * @return The corresponding matroid element
+     */
+
+    inline reference_type name2(size_type index)
+    {
+      return _sources2[index] < 0 ? _names2[-1 - _sources2[index]] : _root->name2(_sources2[index]);
+    }
+
+    /**
+     * @param index A column index
+     * @return The corresponding matroid element
+     */
+
+    inline const_reference_type name2(size_type index) const
+    {
+      return _sources2[index] < 0 ? _names2[-1 - _sources2[index]] : _root->name2(_sources2[index]);
+    }
+
+    /**
+     * @return Reference to the original matroid
+     */
+
+    inline matroid_type& root()
+    {
+      return *_root;
+    }
+
+    /**
+     * @param index A row index
+     * @return Row of the original matroid or a negative number if the row is buffered
+     */
+
+    inline std::ptrdiff_t source1(size_type index) const
+    {
+      return _sources1[index];
+    }
+
+    /**
+     * @param index A column index
+     * @return Column of the original matroid or a negative number if the column is buffered
+     */
+
+    inline std::ptrdiff_t source2(size_type index) const
+    {
+      return _sources2[index];
+    }
+
+  private:
+    matroid_type* _root;
+    std::vector <std::ptrdiff_t> _sources1;
+    std::vector <std::ptrdiff_t> _sources2;
+    std::vector <name_type> _names1;
+    std::vector <name_type> _names2;
+  };
+
+  /**
+   * Free function to perform a pivot on a matroid summand.
+   *
+   * @param matroid The given matroid summand
+   * @param i Row index
+   * @param j Column index
+   */
+
+  template <typename MatroidType>
+  void matroid_binary_pivot(matroid_summand <MatroidType>& matroid, size_t i, size_t j)
+  {
+    std::swap(matroid.name1(i), matroid.name2(j));
+  }
+
+  /**
+   * A representation matrix of a summand of a separated matroid which refers to the entries of the original matrix.
+   * Only marker rows and columns, which the summand shares with the other one, are stored in a buffer. Hence the
+   * entries of both summands are disjoint and each summand may be pivoted independently.
+   */
+
+  template <typename M>
+  class matrix_summand: public boost::numeric::ublas::matrix_expression <matrix_summand <M> >
+  {
+  public:
+    typedef matrix_summand <M> self_type;
+    typedef M matrix_type;
+    typedef typename M::size_type size_type;
+    typedef typename M::difference_type difference_type;
+    typedef typename M::value_type value_type;
+    typedef typename M::const_reference const_reference;
+    typedef typename M::reference reference;
+    typedef typename M::closure_type matrix_closure_type;
+    typedef const self_type const_closure_type;
+    typedef self_type closure_type;
+    typedef typename M::orientation_category orientation_category;
+    typedef typename M::storage_category storage_category;
+
+  private:
+    typedef boost::numeric::ublas::matrix <value_type> buffer_type;
+
+    matrix_type* _root;
+    std::vector <std::ptrdiff_t> _sources1;
+    std::vector <std::ptrdiff_t> _sources2;
+    buffer_type _buffered_rows;
+    buffer_type _buffered_columns;
+
+  public:
+
+    /**
+     * Constructs an empty summand.
+     */
+
+    matrix_summand() :
+      _root(NULL)
+    {
+
+    }
+
+    /**
+     * Refers to the given rows and columns of a matrix. Rows and columns which are markers or which are
+     * buffered by the parent are copied.
+     *
+     * @param parent The separated matrix, which must be based on M
+     * @param rows Rows of the summand
+     * @param columns Columns of the summand
+     */
+
+    template <typename ParentType>
+    void assign(ParentType& parent, const summand_indices& rows, const summand_indices& columns)
+    {
+      _root = &detail::summand_traits <ParentType>::root(parent);
+      size_t num_buffered_rows = detail::map_summand_sources(parent, true, rows.indices(), rows.markers(), _sources1);
+      size_t num_buffered_columns = detail::map_summand_sources(parent, false, columns.indices(), columns.markers(),
+          _sources2);
+
+      _buffered_rows.resize(num_buffered_rows, size2(), false);
+      _buffered_columns.resize(size1(), num_buffered_columns, false);
+
+      for (size_t row = 0; row < size1(); ++row)
+      {
+        for (size_t column = 0; column < size2(); ++column)
+        {
+          if (_sources1[row] < 0)
+            _buffered_rows(-1 - _sources1[row], column) = parent(rows.indices()[row], columns.indices()[column]);
+          else if (_sources2[column] < 0)
+            _buffered_columns(row, -1 - _sources2[column]) = parent(rows.indices()[row], columns.indices()[column]);
+        }
+      }
+    }
+
+    /**
+     * @return Height of the matrix
+     */
+
+    inline size_type size1() const
+    {
+      return _sources1.size();
+    }
+
+    /**
+     * @return Width of the matrix
+     */
+
+    inline size_type size2() const
+    {
+      return _sources2.size();
+    }
+
+    /**
+     * Read-only access operator
+     *
+     * @param i Row index
+     * @param j Column index
+     * @return Buffered entry or original(row-source(i), column-source(j))
+     */
+
+    inline const_reference operator ()(size_type i, size_type j) const
+    {
+      if (_sources1[i] < 0)
+        return _buffered_rows(-1 - _sources1[i], j);
+      else if (_sources2[j] < 0)
+        return _buffered_columns(i, -1 - _sources2[j]);
+      else
+        return const_cast <const matrix_type&> (*_root)(_sources1[i], _sources2[j]);
+    }
+
+    /**
+     * Access operator
+     *
+     * @param i Row index
+     * @param j Column index
+     * @return Buffered entry or original(row-source(i), column-source(j))
+     */
+
+    inline reference operator ()(size_type i, size_type j)
+    {
+      if (_sources1[i] < 0)
+        return _buffered_rows(-1 - _sources1[i], j);
+      else if (_sources2[j] < 0)
+        return _buffered_columns(i, -1 - _sources2[j]);
+      else
+        return (*_root)(_sources1[i], _sources2[j]);
+    }
+
+    /**
+     * @return Reference to the original matrix
+     */
+
+    inline matrix_type& root()
+    {
+      return *_root;
+    }
+
+    /**
+     * @param index A row index
+     * @return Row of the original matrix or a negative number if the row is buffered
+     */
+
+    inline std::ptrdiff_t source1(size_type index) const
+    {
+      return _sources1[index];
+    }
+
+    /**
+     * @param index A column index
+     * @return Column of the original matrix or a negative number if the column is buffered
+     */
+
+    inline std::ptrdiff_t source2(size_type index) const
+    {
+      return _sources2[index];
+    }
+
+    typedef boost::numeric::ublas::detail::indexed_iterator1 <self_type, typename matrix_type::iterator1::iterator_category> iterator1;
+    typedef boost::numeric::ublas::detail::indexed_iterator2 <self_type, typename matrix_type::iterator2::iterator_category> iterator2;
+    typedef boost::numeric::ublas::detail::indexed_const_iterator1 <self_type, typename matrix_type::const_iterator1::iterator_category>
+        const_iterator1;
+    typedef boost::numeric::ublas::detail::indexed_const_iterator2 <self_type, typename matrix_type::const_iterator2::iterator_category>
+        const_iterator2;
+  };
+
+} /* namespace tu */
@@ -338,12 +338,12 @@ TU_ERROR decomposeOneSum(TU* tu, TU_MATRIX* matrix, size_t matrixType, size_t ta
           else if (targetType == sizeof(int) && matrixType == sizeof(double))
           {
             ((int*)compTranspose->entryValues)[compEntry] =
-              (int)(round(((double*)matrix->entryValues)[matrixEntry]) + 0.5);
+              (int) round(((double*)matrix->entryValues)[matrixEntry]);
           }
           else if (targetType == sizeof(char) && matrixType == sizeof(double))
           {
             ((char*)compTranspose->entryValues)[compEntry] =
-              (char)(round(((double*)matrix->entryValues)[matrixEntry]) + 0.5);
+              (char) round(((double*)matrix->entryValues)[matrixEntry]);
           }
           else if (targetType == sizeof(double) && matrixType == sizeof(int))
           {
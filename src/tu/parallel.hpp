@@ -0,0 +1,289 @@
+#pragma once
+
+#include <tu/config.h>
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <limits>
+#include <vector>
+
+#if defined(TU_WITH_THREADS)
+#include <thread>
+#endif /* TU_WITH_THREADS */
+
+namespace tu
+{
+  namespace detail
+  {
+
+    /**
+     * Returns the number of threads that should work on the given number of independent tasks. This is 1 if the
+     * library was built without support for threads.
+     *
+     * @param num_tasks Number of tasks
+     * @return Number of threads, at least 1
+     */
+
+    inline size_t num_worker_threads(size_t num_tasks)
+    {
+#if defined(TU_WITH_THREADS)
+      size_t hardware = std::max <size_t>(std::thread::hardware_concurrency(), 1);
+      return std::max <size_t>(std::min(hardware, num_tasks), 1);
+#else
+      return 1;
+#endif /* TU_WITH_THREADS */
+    }
+
+    /**
+     * Number of threads that run_tasks may start in addition to the running ones. Nested calls of run_tasks share the
+     * budget of the thread that started them, such that recursive task trees do not start more threads than allowed.
+     */
+
+    struct thread_budget
+    {
+      thread_budget(size_t num_threads) :
+        idle(std::max <size_t>(num_threads, 1) - 1)
+      {
+
+      }
+
+      std::atomic <size_t> idle;
+    };
+
+    /**
+     * @return Budget of the calling thread, which tu::set_num_threads initializes. By default, it has no idle threads.
+     */
+
+    inline thread_budget& own_thread_budget()
+    {
+      static thread_local thread_budget budget(1);
+      return budget;
+    }
+
+    /**
+     * @return Budget that run_tasks uses in the calling thread. This is the budget of the thread that started it, if
+     * any, and its own budget otherwise.
+     */
+
+    inline thread_budget*& current_thread_budget()
+    {
+      static thread_local thread_budget* budget = &own_thread_budget();
+      return budget;
+    }
+
+    /**
+     * @return Number of threads, including the calling one, that run_tasks could currently use for many tasks
+     */
+
+    inline size_t available_threads()
+    {
+      return std::min(num_worker_threads(std::numeric_limits <size_t>::max()), 1 + current_thread_budget()->idle);
+    }
+
+    /**
+     * Limits the threads used by the calling thread, including itself and the threads started by it, to the given
+     * number for the lifetime of the object.
+     */
+
+    class scoped_thread_limit
+    {
+    public:
+      scoped_thread_limit(size_t num_threads) :
+        _budget(num_threads), _previous(current_thread_budget())
+      {
+        current_thread_budget() = &_budget;
+      }
+
+      ~scoped_thread_limit()
+      {
+        current_thread_budget() = _previous;
+      }
+
+    private:
+      thread_budget _budget;
+      thread_budget* _previous;
+    };
+
+    /**
+     * Calls a worker and stores an exception thrown by it instead of passing it on. The worker uses the given thread
+     * budget.
+     */
+
+    template <typename Worker>
+    struct exception_catching_worker
+    {
+      Worker& worker;
+      std::vector <std::exception_ptr>& exceptions;
+      thread_budget* budget;
+
+      void operator()(size_t thread) const
+      {
+        current_thread_budget() = budget;
+        try
+        {
+          worker(thread);
+        }
+        catch (...)
+        {
+          exceptions[thread] = std::current_exception();
+        }
+      }
+    };
+
+    /**
+     * Calls worker(0), ..., worker(num_threads - 1) concurrently and waits for all of them. worker(0) is called by the
+     * calling thread, as well as the workers for which no thread could be started. If workers throw exceptions, then
+     * the one of the smallest index is rethrown after all threads have finished.
+     *
+     * @param num_threads Number of threads
+     * @param worker Functor taking the thread index
+     */
+
+    template <typename Worker>
+    inline void run_worker_threads(size_t num_threads, Worker worker)
+    {
+#if defined(TU_WITH_THREADS)
+      std::vector <std::exception_ptr> exceptions(num_threads);
+      exception_catching_worker <Worker> catching_worker = { worker, exceptions, current_thread_budget() };
+      std::vector <std::thread> threads;
+      try
+      {
+        threads.reserve(num_threads);
+        for (size_t t = 1; t < num_threads; ++t)
+          threads.push_back(std::thread(catching_worker, t));
+      }
+      catch (...)
+      {
+      }
+      for (size_t t = 0; t < num_threads - threads.size(); ++t)
+        catching_worker(t == 0 ? 0 : threads.size() + t);
+      for (size_t t = 0; t < threads.size(); ++t)
+        threads[t].join();
+      for (size_t t = 0; t < num_threads; ++t)
+      {
+        if (exceptions[t])
+          std::rethrow_exception(exceptions[t]);
+      }
+#else
+      for (size_t t = 0; t < num_threads; ++t)
+        worker(t);
+#endif /* TU_WITH_THREADS */
+    }
+
+    /**
+     * Reserves up to the given number of idle threads of the current thread budget.
+     *
+     * @param num_threads Number of wanted threads
+     * @return Number of reserved threads
+     */
+
+    inline size_t reserve_threads(size_t num_threads)
+    {
+      std::atomic <size_t>& idle_threads = current_thread_budget()->idle;
+      size_t idle = idle_threads;
+      size_t reserved;
+      do
+      {
+        reserved = std::min(idle, num_threads);
+      }
+      while (reserved > 0 && !idle_threads.compare_exchange_weak(idle, idle - reserved));
+      return reserved;
+    }
+
+    /**
+     * Releases threads reserved by reserve_threads.
+     *
+     * @param num_threads Number of reserved threads
+     */
+
+    inline void release_threads(size_t num_threads)
+    {
+      current_thread_budget()->idle += num_threads;
+    }
+
+    /**
+     * Calls worker(0), ..., worker(k - 1) concurrently and waits for all of them, where k - 1 is the number of idle
+     * threads that could be reserved, but at most num_threads - 1. worker(0) is called by the calling thread. Workers
+     * must therefore not rely on running concurrently.
+     *
+     * @param num_threads Maximal number of threads
+     * @param worker Functor taking the thread index
+     */
+
+    template <typename Worker>
+    inline void run_reserved_worker_threads(size_t num_threads, Worker worker)
+    {
+      size_t num_extra_threads = reserve_threads(std::max <size_t>(num_threads, 1) - 1);
+      if (num_extra_threads == 0)
+      {
+        worker(0);
+        return;
+      }
+
+      try
+      {
+        run_worker_threads(1 + num_extra_threads, worker);
+      }
+      catch (...)
+      {
+        release_threads(num_extra_threads);
+        throw;
+      }
+      release_threads(num_extra_threads);
+    }
+
+    /**
+     * Worker that processes the tasks of run_tasks in increasing order until none are left. If a task throws an
+     * exception, then no further tasks are started.
+     */
+
+    template <typename Task>
+    struct task_worker
+    {
+      Task& task;
+      std::atomic <size_t>& next_task;
+      size_t num_tasks;
+
+      void operator()(size_t thread) const
+      {
+        try
+        {
+          for (size_t t = next_task++; t < num_tasks; t = next_task++)
+            task(t);
+        }
+        catch (...)
+        {
+          next_task = num_tasks;
+          throw;
+        }
+      }
+    };
+
+    /**
+     * Calls task(0), ..., task(num_tasks - 1), distributing them among the calling thread and up to
+     * num_worker_threads(num_tasks) - 1 idle threads. Tasks are started in increasing order, so without idle threads
+     * they are processed sequentially by the calling thread, which then directly calls them one after the other. An
+     * exception thrown by a task is passed on after all running tasks have finished.
+     *
+     * @param num_tasks Number of tasks
+     * @param task Functor taking the task index
+     */
+
+    template <typename Task>
+    inline void run_tasks(size_t num_tasks, Task task)
+    {
+      if (num_tasks < 2 || current_thread_budget()->idle == 0)
+      {
+        for (size_t t = 0; t < num_tasks; ++t)
+          task(t);
+        return;
+      }
+
+      std::atomic <size_t> next_task(0);
+      task_worker <Task> worker = { task, next_task, num_tasks };
+      run_reserved_worker_threads(num_worker_threads(num_tasks), worker);
+    }
+
+  } /* namespace detail */
+} /* namespace tu */
@@ -86,13 +86,20 @@ namespace tu
 
     rank_distribution result = RANK_TOO_HIGH;
 
+    /// The spaces and vectors are reused between the iterations.
+    binary_linear_space bottom_left_row_space(top_left_width);
+    binary_linear_space top_right_row_space(bottom_right_width);
+    binary_linear_space top_right_column_space(top_left_height);
+    binary_linear_space bottom_left_column_space(bottom_right_height);
+    binary_linear_space::vector_type bottom_left_row, top_right_row, top_right_column, bottom_left_column;
+
     /// Repeat until no rows/columns can be shifted.
     bool changed = true;
     while (changed)
     {
       /// Setup bottom left rows
-      binary_linear_space bottom_left_row_space(top_left_width);
-      std::vector <bool> bottom_left_row(top_left_width);
+      bottom_left_row_space.clear(top_left_width);
+      bottom_left_row.resize(top_left_width);
 
       for (size_t row = free_rows_beyond; row < height; ++row)
       {
@@ -101,8 +108,8 @@ namespace tu
       }
 
       /// Setup top right rows
-      binary_linear_space top_right_row_space(bottom_right_width);
-      std::vector <bool> top_right_row(bottom_right_width);
+      top_right_row_space.clear(bottom_right_width);
+      top_right_row.resize(bottom_right_width);
 
       for (size_t row = 0; row < top_left_height; ++row)
       {
@@ -134,8 +141,8 @@ namespace tu
       }
 
       /// Setup top right columns
-      binary_linear_space top_right_column_space(top_left_height);
-      std::vector <bool> top_right_column(top_left_height);
+      top_right_column_space.clear(top_left_height);
+      top_right_column.resize(top_left_height);
 
       for (size_t column = free_columns_beyond; column < width; ++column)
       {
@@ -144,8 +151,8 @@ namespace tu
       }
 
       /// Setup bottom left columns
-      binary_linear_space bottom_left_column_space(bottom_right_height);
-      std::vector <bool> bottom_left_column(bottom_right_height);
+      bottom_left_column_space.clear(bottom_right_height);
+      bottom_left_column.resize(bottom_right_height);
 
       for (size_t column = 0; column < top_left_width; ++column)
       {
@@ -42,10 +42,9 @@ namespace tu
 
     static bipartite_r10_graphs& instance()
     {
-      static bipartite_r10_graphs* instance = NULL;
-      if (instance == NULL)
-        instance = new bipartite_r10_graphs();
-      return *instance;
+      /// Initialization of local statics is thread-safe.
+      static bipartite_r10_graphs instance;
+      return instance;
     }
 
   public:
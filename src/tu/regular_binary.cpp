@@ -0,0 +1,117 @@
+#include "regular_binary.h"
+
+#include "algorithm.hpp"
+#include "matroid.hpp"
+#include "violator_search.hpp"
+#include "logger.hpp"
+#include "parallel.hpp"
+
+#include <cassert>
+#include <cstdio>
+#include <new>
+
+namespace tu
+{
+
+  /**
+   * Binary representation matrix with one byte per entry, which is used for the decomposition of components that are
+   * passed in sparse form.
+   */
+
+  typedef boost::numeric::ublas::matrix <char> binary_matrix;
+
+  /**
+   * Decomposes the support matroid of a given ternary matrix and, if it is not regular, searches for a
+   * violating submatrix. The decomposition works on a dense binary copy, while the signed matrix is only densified
+   * for the violator search.
+   *
+   * @param matrix Signed ternary matrix
+   * @param violator Returns violator indices if not NULL and the matroid is not regular
+   * @return true if and only if the support matroid is regular
+   */
+
+  static bool test_regular_binary(TU_CHRMAT* matrix, submatrix_indices* violator)
+  {
+    logger log(LOG_QUIET);
+
+    bool transposed = matrix->numRows >= matrix->numColumns;
+    binary_matrix worker_matrix(transposed ? matrix->numColumns : matrix->numRows,
+        transposed ? matrix->numRows : matrix->numColumns, 0);
+    for (int row = 0; row < matrix->numRows; ++row)
+    {
+      int begin = matrix->rowStarts[row];
+      int end = row + 1 < matrix->numRows ? matrix->rowStarts[row + 1] : matrix->numNonzeros;
+      for (int entry = begin; entry < end; ++entry)
+      {
+        if (transposed)
+          worker_matrix(matrix->entryColumns[entry], row) = 1;
+        else
+          worker_matrix(row, matrix->entryColumns[entry]) = 1;
+      }
+    }
+
+    integer_matroid worker_matroid(worker_matrix.size1(), worker_matrix.size2());
+
+    std::pair <bool, decomposed_matroid*> result = decompose_binary_matroid(worker_matroid, worker_matrix,
+        matroid_element_set(), false, log);
+    assert(result.second == NULL);
+
+    if (result.first || !violator)
+      return result.first;
+
+    worker_matrix.resize(0, 0, false);
+    integer_matrix dense(matrix->numRows, matrix->numColumns, 0);
+    for (int row = 0; row < matrix->numRows; ++row)
+    {
+      int begin = matrix->rowStarts[row];
+      int end = row + 1 < matrix->numRows ? matrix->rowStarts[row + 1] : matrix->numNonzeros;
+      for (int entry = begin; entry < end; ++entry)
+        dense(row, matrix->entryColumns[entry]) = matrix->entryValues[entry];
+    }
+
+    matroid_element_set rows, columns;
+    for (std::size_t r = 0; r < dense.size1(); ++r)
+      rows.insert(-1 - r);
+    for (std::size_t c = 0; c < dense.size2(); ++c)
+      columns.insert(1 + c);
+
+    detail::greedy_violator_strategy strategy(dense, rows, columns, log);
+    strategy.search();
+    strategy.create_matrix(*violator);
+
+    assert(violator->rows.size() == violator->columns.size());
+
+    return false;
+  }
+
+} /* namespace tu */
+
+TU_ERROR testRegularBinary(TU* tu, TU_CHRMAT* matrix, int numThreads, bool* pisRegular, TU_SUBMAT** psubmatrix)
+{
+  assert(tu);
+  assert(matrix);
+  assert(pisRegular);
+  assert(!psubmatrix || !*psubmatrix);
+
+  try
+  {
+    tu::detail::scoped_thread_limit limit(numThreads);
+    tu::submatrix_indices violator;
+    *pisRegular = tu::test_regular_binary(matrix, psubmatrix ? &violator : NULL);
+
+    if (!*pisRegular && psubmatrix)
+    {
+      TU_CALL( TUsubmatCreate(tu, psubmatrix, violator.rows.size(), violator.columns.size()) );
+      for (std::size_t r = 0; r < violator.rows.size(); ++r)
+        (*psubmatrix)->rows[r] = violator.rows[r];
+      for (std::size_t c = 0; c < violator.columns.size(); ++c)
+        (*psubmatrix)->columns[c] = violator.columns[c];
+    }
+  }
+  catch (std::bad_alloc&)
+  {
+    return TU_ERROR_MEMORY;
+  }
+
+  return TU_OKAY;
+}
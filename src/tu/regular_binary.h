@@ -0,0 +1,35 @@
+#ifndef TU_REGULAR_BINARY_INTERNAL_H
+#define TU_REGULAR_BINARY_INTERNAL_H
+
+#include <tu/env.h>
+#include <tu/matrix.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief Tests the support matroid of a signed, connected char matrix for regularity.
+ *
+ * The \p matrix is assumed to be ternary and to be its own signed version, i.e., it is TU if and only if its support
+ * matrix represents a regular matroid. The test decomposes the binary matroid into 1-, 2- and 3-sums of graphic,
+ * cographic and R10 components. It is meant for matrices that were already found to be neither graphic nor
+ * cographic.
+ *
+ * If \p psubmatrix is not \c NULL and the matroid is not regular, then a submatrix of \p matrix with an absolute
+ * determinant larger than 1 is stored in *\p psubmatrix and the caller must use \ref TUsubmatFree to free its memory.
+ */
+
+TU_ERROR testRegularBinary(
+  TU* tu,                 /**< \ref TU environment. */
+  TU_CHRMAT* matrix,      /**< Signed ternary matrix. */
+  int numThreads,         /**< Number of threads the test may use, including the calling one. */
+  bool* pisRegular,       /**< Pointer for storing whether the support matroid is regular. */
+  TU_SUBMAT** psubmatrix  /**< Pointer for storing a submatrix with a bad determinant (may be \c NULL). */
+);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TU_REGULAR_BINARY_INTERNAL_H */
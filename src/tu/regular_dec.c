@@ -5,12 +5,12 @@
 
 #include "env_internal.h"
 
-void TUcreateDec(TU* tu, TU_DEC** pdec)
+TU_ERROR TUcreateDec(TU* tu, TU_DEC** pdec)
 {
   assert(pdec != NULL);
   assert(*pdec == NULL);
 
-  TUallocBlock(tu, pdec);
+  TU_CALL( TUallocBlock(tu, pdec) );
   TU_DEC* dec = *pdec;
   dec->matrix = NULL;
   dec->transpose = NULL;
@@ -23,6 +23,8 @@ void TUcreateDec(TU* tu, TU_DEC** pdec)
   dec->numChildren = 0;
   dec->graph = NULL;
   dec->cograph = NULL;
+
+  return TU_OKAY;
 }
 
 void TUdecFree(TU* tu, TU_DEC** pdec)
@@ -6,7 +6,7 @@
 /**
  * \brief Creates a decomposition tree node.
  */
-void TUcreateDec(
+TU_ERROR TUcreateDec(
   TU* tu,       /**< TU environment. */
   TU_DEC** dec  /**< Pointer to decomposition tree. */
 );
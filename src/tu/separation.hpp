@@ -5,6 +5,7 @@
 #include <vector>
 #include "nested_minor_sequence.hpp"
 #include "matroid.hpp"
+#include "matroid_summand.hpp"
 #include <tu/total_unimodularity.hpp>
 
 namespace tu
@@ -179,7 +180,9 @@ namespace tu
     }
 
     /**
-     * Creates both components as matroids and representation matrices.
+     * Creates both components as summands which refer to the original matroid and its representation matrix. Only
+     * the marker rows and columns, which both components share, are copied. The components may be pivoted
+     * independently afterwards, which changes the original matrix.
      *
      * @param matroid The original matroid
      * @param matrix Representation matrix of the given original matroid
@@ -189,139 +192,68 @@ namespace tu
      * @param lower_right_matrix New lower right component representation matrix
      */
 
-    template <typename MatroidType, typename MatrixType>
-    void create_components(const MatroidType& matroid, const MatrixType& matrix, integer_matroid& upper_left_matroid,
-        integer_matrix& upper_left_matrix, integer_matroid& lower_right_matroid, integer_matrix& lower_right_matrix) const
+    template <typename MatroidType, typename MatrixType, typename SummandMatroidType, typename SummandMatrixType>
+    void create_components(MatroidType& matroid, MatrixType& matrix, SummandMatroidType& upper_left_matroid,
+        SummandMatrixType& upper_left_matrix, SummandMatroidType& lower_right_matroid,
+        SummandMatrixType& lower_right_matrix) const
     {
       assert (is_valid());
       assert (matroid.size1() == matrix.size1());
       assert (matroid.size2() == matrix.size2());
 
-      /// 1-separation
+      summand_indices upper_left_rows, upper_left_columns, lower_right_rows, lower_right_columns;
+
       if (rank() == 0)
       {
-        upper_left_matroid.resize(split_.first, split_.second);
-        for (size_t row = 0; row < upper_left_matroid.size1(); ++row)
-          upper_left_matroid.name1(row) = matroid.name1(row);
-        for (size_t column = 0; column < upper_left_matroid.size2(); ++column)
-          upper_left_matroid.name2(column) = matroid.name2(column);
-        upper_left_matrix.resize(split_.first, split_.second, false);
-        for (size_t row = 0; row < upper_left_matrix.size1(); ++row)
-        {
-          for (size_t column = 0; column < upper_left_matrix.size2(); ++column)
-            upper_left_matrix(row, column) = matrix(row, column);
-        }
-
-        lower_right_matroid.resize(matroid.size1() - split_.first, matroid.size2() - split_.second);
-        for (size_t row = 0; row < lower_right_matroid.size1(); ++row)
-          lower_right_matroid.name1(row) = matroid.name1(split_.first + row);
-        for (size_t column = 0; column < lower_right_matroid.size2(); ++column)
-          lower_right_matroid.name2(column) = matroid.name2(split_.second + column);
-        lower_right_matrix.resize(matrix.size1() - split_.first, matrix.size2() - split_.second, false);
-        for (size_t row = 0; row < lower_right_matrix.size1(); ++row)
-        {
-          for (size_t column = 0; column < lower_right_matrix.size2(); ++column)
-            lower_right_matrix(row, column) = matrix(split_.first + row, split_.second + column);
-        }
+        /// 1-separation
+
+        upper_left_rows.add_range(0, split_.first);
+        upper_left_columns.add_range(0, split_.second);
+        lower_right_rows.add_range(split_.first, matroid.size1());
+        lower_right_columns.add_range(split_.second, matroid.size2());
       }
       else if (rank() == 1 && witness().first >= split_.first)
       {
         /// 2-separation with lower left rank 1
 
-        upper_left_matroid.resize(split_.first + 1, split_.second);
-        for (size_t row = 0; row < split_.first; ++row)
-          upper_left_matroid.name1(row) = matroid.name1(row);
-        upper_left_matroid.name1(split_.first) = matroid.name1(witness().first);
-        for (size_t column = 0; column < upper_left_matroid.size2(); ++column)
-          upper_left_matroid.name2(column) = matroid.name2(column);
-
-        upper_left_matrix.resize(split_.first + 1, split_.second, false);
-        for (size_t column = 0; column < upper_left_matrix.size2(); ++column)
-        {
-          for (size_t row = 0; row < split_.first; ++row)
-            upper_left_matrix(row, column) = matrix(row, column);
-          upper_left_matrix(split_.first, column) = matrix(witness().first, column);
-        }
-
-        lower_right_matroid.resize(matroid.size1() - split_.first, matroid.size2() - split_.second + 1);
-        for (size_t row = 0; row < lower_right_matroid.size1(); ++row)
-          lower_right_matroid.name1(row) = matroid.name1(split_.first + row);
-        for (size_t column = 1; column < lower_right_matroid.size2(); ++column)
-          lower_right_matroid.name2(column) = matroid.name2(split_.second + column - 1);
-        lower_right_matroid.name2(0) = matroid.name2(witness().second);
-
-        lower_right_matrix.resize(matrix.size1() - split_.first, matrix.size2() - split_.second + 1, false);
-        for (size_t row = 0; row < lower_right_matrix.size1(); ++row)
-        {
-          for (size_t column = 1; column < lower_right_matrix.size2(); ++column)
-            lower_right_matrix(row, column) = matrix(split_.first + row, split_.second + column - 1);
-          lower_right_matrix(row, 0) = matrix(split_.first + row, witness().second);
-        }
+        upper_left_rows.add_range(0, split_.first);
+        upper_left_rows.add(witness().first, true);
+        upper_left_columns.add_range(0, split_.second);
+        lower_right_rows.add_range(split_.first, matroid.size1());
+        lower_right_columns.add(witness().second, true);
+        lower_right_columns.add_range(split_.second, matroid.size2());
       }
       else if (rank() == 1 && witness().second >= split_.second)
       {
         /// 2-separation with upper right rank 1
 
-        upper_left_matroid.resize(split_.first, split_.second + 1);
-        for (size_t row = 0; row < split_.first; ++row)
-          upper_left_matroid.name1(row) = matroid.name1(row);
-        for (size_t column = 0; column < split_.second; ++column)
-          upper_left_matroid.name2(column) = matroid.name2(column);
-        upper_left_matroid.name2(split_.second) = matroid.name2(witness().second);
-
-        upper_left_matrix.resize(split_.first, split_.second + 1, false);
-        for (size_t row = 0; row < split_.first; ++row)
-        {
-          for (size_t column = 0; column < split_.second; ++column)
-            upper_left_matrix(row, column) = matrix(row, column);
-          upper_left_matrix(row, split_.second) = matrix(row, witness().second);
-        }
-
-        lower_right_matroid.resize(matroid.size1() - split_.first + 1, matroid.size2() - split_.second);
-        for (size_t row = 1; row < lower_right_matroid.size1(); ++row)
-          lower_right_matroid.name1(row) = matroid.name1(split_.first + row - 1);
-        for (size_t column = 0; column < lower_right_matroid.size2(); ++column)
-          lower_right_matroid.name2(column) = matroid.name2(split_.second + column);
-        lower_right_matroid.name1(0) = matroid.name1(witness().first);
-
-        lower_right_matrix.resize(matrix.size1() - split_.first + 1, matrix.size2() - split_.second, false);
-        for (size_t column = 0; column < lower_right_matrix.size2(); ++column)
-        {
-          for (size_t row = 1; row < lower_right_matrix.size1(); ++row)
-            lower_right_matrix(row, column) = matrix(split_.first + row - 1, split_.second + column);
-          lower_right_matrix(0, column) = matrix(witness().first, split_.second + column);
-        }
+        upper_left_rows.add_range(0, split_.first);
+        upper_left_columns.add_range(0, split_.second);
+        upper_left_columns.add(witness().second, true);
+        lower_right_rows.add(witness().first, true);
+        lower_right_rows.add_range(split_.first, matroid.size1());
+        lower_right_columns.add_range(split_.second, matroid.size2());
       }
       else
       {
         /// 3-separation
 
-        upper_left_matroid.resize(split_.first + 2, split_.second + 1);
-        for (size_t row = 0; row < split_.first + 2; ++row)
-          upper_left_matroid.name1(row) = matroid.name1(row);
-        for (size_t column = 0; column < split_.second + 1; ++column)
-          upper_left_matroid.name2(column) = matroid.name2(column);
-
-        upper_left_matrix.resize(split_.first + 2, split_.second + 1, false);
-        for (size_t row = 0; row < split_.first + 2; ++row)
-        {
-          for (size_t column = 0; column < split_.second + 1; ++column)
-            upper_left_matrix(row, column) = matrix(row, column);
-        }
-
-        lower_right_matroid.resize(matroid.size1() - split_.first + 1, matroid.size2() - split_.second + 2);
-        for (size_t row = 0; row < lower_right_matroid.size1(); ++row)
-          lower_right_matroid.name1(row) = matroid.name1(split_.first + row - 1);
-        for (size_t column = 0; column < lower_right_matroid.size2(); ++column)
-          lower_right_matroid.name2(column) = matroid.name2(split_.second + column - 2);
-
-        lower_right_matrix.resize(matrix.size1() - split_.first + 1, matrix.size2() - split_.second + 2, false);
-        for (size_t column = 0; column < lower_right_matrix.size2(); ++column)
-        {
-          for (size_t row = 0; row < lower_right_matrix.size1(); ++row)
-            lower_right_matrix(row, column) = matrix(split_.first + row - 1, split_.second + column - 2);
-        }
+        upper_left_rows.add_range(0, split_.first);
+        upper_left_rows.add(split_.first, true);
+        upper_left_rows.add(split_.first + 1, true);
+        upper_left_columns.add_range(0, split_.second);
+        upper_left_columns.add(split_.second, true);
+        lower_right_rows.add(split_.first - 1, true);
+        lower_right_rows.add_range(split_.first, matroid.size1());
+        lower_right_columns.add(split_.second - 2, true);
+        lower_right_columns.add(split_.second - 1, true);
+        lower_right_columns.add_range(split_.second, matroid.size2());
       }
+
+      upper_left_matroid.assign(matroid, upper_left_rows, upper_left_columns);
+      upper_left_matrix.assign(matrix, upper_left_rows, upper_left_columns);
+      lower_right_matroid.assign(matroid, lower_right_rows, lower_right_columns);
+      lower_right_matrix.assign(matrix, lower_right_rows, lower_right_columns);
     }
 
   private:
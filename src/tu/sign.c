@@ -15,7 +15,7 @@
 
 typedef struct
 {
-  int status;             /**< \brief 0: not visited, 1: in queue, 2: processed */
+  int visit;              /**< \brief Row in whose BFS this node was last visited, or -1. */
   int predecessorNode;    /**< \brief Node number of predecessor. */
   char predecessorValue;  /**< \brief Value of matrix entry of predecessor. */
   char targetValue;       /**< \brief Entry in current row if a target node, and 0 otherwise. */
@@ -67,21 +67,27 @@ TU_ERROR signSequentiallyConnected(
   TUallocStackArray(tu, &graphNodes, matrix->numColumns + matrix->numRows);
   TUallocStackArray(tu, &bfsQueue, matrix->numColumns + matrix->numRows);
 
+  /* Instead of resetting all nodes for each row, nodes store the row of their last visit. Target values are reset after
+   * each row. */
+  for (int v = 0; v < matrix->numColumns + matrix->numRows; ++v)
+  {
+    graphNodes[v].targetValue = 0;
+    graphNodes[v].visit = -1;
+    graphNodes[v].predecessorNode = -1;
+  }
+
   /* Main loop iterates over the rows. */
   for (int row = 1; row < matrix->numRows; ++row)
   {
+    /* The result of a cancelled task is ignored. */
+    if (TUtasksCancelled(tu))
+      break;
+
     TUdbgMsg(2, "Before processing row %d:\n", row);
 #if defined(TU_DEBUG)
     TUchrmatPrintDense(stdout, matrix, ' ', true);
 #endif
 
-    for (int v = 0; v < matrix->numColumns + matrix->numRows; ++v)
-    {
-      graphNodes[v].targetValue = 0;
-      graphNodes[v].status = 0;
-      graphNodes[v].predecessorNode = -1;
-    }
-
     bool rowChanged = false;
     int begin = matrix->rowStarts[row];
     int end = matrix->rowStarts[row+1];
@@ -93,19 +99,29 @@ TU_ERROR signSequentiallyConnected(
 
     /* First nonzero in row determines start column node. */
     int startNode = matrix->entryColumns[begin];
-    /* All columns of the row's nonzeros are target column nodes. */
+    /* All columns of the row's nonzeros are target column nodes. Those that appear in previous rows are reachable by
+     * the BFS, since rows and columns of a connected component are ordered such that each row shares a column with a
+     * previous row. Since transpose is sorted, the first entry of a column is in its first row. */
+    int numMissingTargets = 0;
     for (int e = begin; e < end; ++e)
-      graphNodes[matrix->entryColumns[e]].targetValue = matrix->entryValues[e];
+    {
+      int c = matrix->entryColumns[e];
+      graphNodes[c].targetValue = matrix->entryValues[e];
+      if (c != startNode && transpose->entryColumns[transpose->rowStarts[c]] < row)
+        ++numMissingTargets;
+    }
+    assert(transpose->entryColumns[transpose->rowStarts[startNode]] < row);
     bfsQueue[0] = startNode;
-    graphNodes[startNode].status = 1;
+    graphNodes[startNode].visit = row;
+    graphNodes[startNode].predecessorNode = -1;
     bfsQueueBegin = 0;
     bfsQueueEnd = 1;
 
-    while (bfsQueueBegin < bfsQueueEnd)
+    /* The BFS stops as soon as all target nodes are reached. */
+    while (bfsQueueBegin < bfsQueueEnd && numMissingTargets > 0)
     {
       int currentNode = bfsQueue[bfsQueueBegin];
-      assert(graphNodes[currentNode].status == 1);
-      graphNodes[currentNode].status = 2;
+      assert(graphNodes[currentNode].visit == row);
       ++bfsQueueBegin;
 
       if (currentNode >= firstRowNode)
@@ -119,9 +135,9 @@ TU_ERROR signSequentiallyConnected(
         for (int e = begin; e < end; ++e)
         {
           int c = matrix->entryColumns[e];
-          if (graphNodes[c].status == 0)
+          if (graphNodes[c].visit != row)
           {
-            graphNodes[c].status = 1;
+            graphNodes[c].visit = row;
             graphNodes[c].predecessorNode = currentNode;
             graphNodes[c].predecessorValue = matrix->entryValues[e];
             bfsQueue[bfsQueueEnd++] = c;
@@ -129,6 +145,7 @@ TU_ERROR signSequentiallyConnected(
                node (which might be the starting node). */
             if (graphNodes[c].targetValue != 0)
             {
+              --numMissingTargets;
               int length = 2;
               int sum = graphNodes[c].targetValue;
               int pathNode = c;
@@ -200,9 +217,9 @@ TU_ERROR signSequentiallyConnected(
           /* Only rows before current iteration row participate. */
           if (r >= row)
             break;
-          if (graphNodes[firstRowNode + r].status == 0)
+          if (graphNodes[firstRowNode + r].visit != row)
           {
-            graphNodes[firstRowNode + r].status = 1;
+            graphNodes[firstRowNode + r].visit = row;
             graphNodes[firstRowNode + r].predecessorNode = currentNode;
             graphNodes[firstRowNode + r].predecessorValue = transpose->entryValues[e];
             bfsQueue[bfsQueueEnd++] = firstRowNode + r;
@@ -225,17 +242,18 @@ TU_ERROR signSequentiallyConnected(
     }
 #endif
 
-    if (rowChanged)
+    begin = matrix->rowStarts[row];
+    end = matrix->rowStarts[row+1];
+    for (int e = begin; e < end; ++e)
     {
-      begin = matrix->rowStarts[row];
-      end = matrix->rowStarts[row+1];
-      for (int e = begin; e < end; ++e)
+      int column = matrix->entryColumns[e];
+      if (rowChanged)
       {
-        int column = matrix->entryColumns[e];
         if (matrix->entryValues[e] != graphNodes[column].targetValue)
           TUdbgMsg(2, "Sign change at %d,%d.\n", row, column);
         matrix->entryValues[e] = graphNodes[column].targetValue;
       }
+      graphNodes[column].targetValue = 0;
     }
   }
 
@@ -21,6 +21,8 @@ extern "C" {
  * If \p submatrix is not \c NULL and sign changes are necessary, then a submatrix with determinant
  * -2 or +2 is stored in *\p psubmatrix and the caller must use \ref TUsubmatFree free its
  * memory. It is set to \c NULL if no sign changes are needed.
+ *
+ * If it runs in a task of \ref TUrunTasks that gets cancelled, then it stops early and its result is meaningless.
  */
 
 TU_ERROR signSequentiallyConnected(
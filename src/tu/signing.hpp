@@ -2,6 +2,7 @@
 
 #include <tu/total_unimodularity.hpp>
 
+#include <atomic>
 #include <set>
 
 #include <boost/type_traits/is_const.hpp>
@@ -131,11 +132,12 @@ namespace tu
    *
    * @param matrix The given matrix
    * @param violator Pointer to violator indices to be filled.
+   * @param cancelled If not NULL and set, then the procedure stops early with a meaningless result.
    * @return true if and only if the matrix is signed already.
    */
 
   template <typename M>
-  bool sign_matrix(M& matrix, submatrix_indices* violator)
+  bool sign_matrix(M& matrix, submatrix_indices* violator, const std::atomic <bool>* cancelled = NULL)
   {
     bool result = true;
     matrix_permuted <M> permuted(matrix);
@@ -144,6 +146,9 @@ namespace tu
     /// Go trough column by column.
     for (size_t handled_columns = 0; handled_columns < permuted.size2(); ++handled_columns)
     {
+      if (cancelled && *cancelled)
+        return result;
+
       if (find_nonzero_column(permuted, handled_columns, permuted.size2(), 0, handled_rows, handled_columns))
       {
         /// There is a non-zero column right of the already-handled submatrix.
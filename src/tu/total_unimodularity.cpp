@@ -5,13 +5,273 @@
 #include "violator_search.hpp"
 #include "signing.hpp"
 #include "logger.hpp"
+#include "parallel.hpp"
 #include <tu/sign.h>
+#include <tu/tu.h>
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <stdexcept>
 
 namespace tu
 {
 
+  namespace detail
+  {
+
+    /**
+     * Tests if a given matrix is a signed version of its support matrix already.
+     *
+     * @param matrix The matrix to be tested
+     * @param cancelled If not NULL, then the test stops early once this flag is set and its result is meaningless
+     * @return true if and only if the support matrix can be signed to the orignal
+     */
+
+    static bool is_signed_matrix(const integer_matrix& matrix, const std::atomic <bool>* cancelled)
+    {
+      if (matrix.size2() > matrix.size1())
+      {
+        const matrix_transposed <const integer_matrix> transposed(matrix);
+        return sign_matrix(transposed, NULL, cancelled);
+      }
+      else
+      {
+        return sign_matrix(matrix, NULL, cancelled);
+      }
+    }
+
+    /**
+     * Runs the signing test (task 0) or the decomposition of the support matroid (task 1). A negative result of one
+     * sets cancelled, which aborts the other since the matrix is not totally unimodular anyway.
+     */
+
+    struct signing_and_decomposition
+    {
+      const integer_matrix& matrix;
+      integer_matroid& worker_matroid;
+      integer_matrix& worker_matrix;
+      logger& log;
+      std::atomic <bool>& cancelled;
+      bool* results;
+
+      void operator()(size_t task) const
+      {
+        if (task == 0)
+          results[0] = is_signed_matrix(matrix, &cancelled);
+        else
+        {
+          results[1] = decompose_binary_matroid(worker_matroid, worker_matrix, matroid_element_set(), false, log,
+              &cancelled).first;
+        }
+
+        if (!results[task])
+          cancelled = true;
+      }
+    };
+
+    /**
+     * Tests a sparse matrix for total unimodularity using the C library, which keeps it sparse as far as possible.
+     *
+     * @param matrix The matrix to be tested
+     * @param violator Returns violator indices if not NULL and the matrix is not totally unimodular
+     * @return true if and only if the matrix is totally unimodular
+     */
+
+    static bool test_sparse_total_unimodularity(const SparseMatrix <char>& matrix, submatrix_indices* violator)
+    {
+      TU* tu = NULL;
+      if (TUcreateEnvironment(&tu) != TU_OKAY)
+        throw std::bad_alloc();
+
+      TU_CHRMAT* library_matrix = NULL;
+      TU_SUBMAT* submatrix = NULL;
+      bool is_tu = false;
+      TU_ERROR error = TUchrmatCreate(tu, &library_matrix, matrix.numRows(), matrix.numColumns(),
+          matrix.numNonzeros());
+      if (error == TU_OKAY)
+      {
+        /// The C library expects the entries of each row to be sorted by column.
+        std::vector <std::pair <int, char> > row_entries;
+        int entry = 0;
+        for (size_t row = 0; row < matrix.numRows(); ++row)
+        {
+          row_entries.clear();
+          for (auto nonzero : matrix.iterateRowNonzeros(row))
+            row_entries.push_back(std::make_pair(int(nonzero.column), nonzero.value));
+          if (!matrix.hasSortedRows())
+            std::sort(row_entries.begin(), row_entries.end());
+
+          library_matrix->rowStarts[row] = entry;
+          for (size_t i = 0; i < row_entries.size(); ++i, ++entry)
+          {
+            library_matrix->entryColumns[entry] = row_entries[i].first;
+            library_matrix->entryValues[entry] = row_entries[i].second;
+          }
+        }
+
+        error = TUtestTotalUnimodularityChr(tu, library_matrix, &is_tu, NULL, violator ? &submatrix : NULL);
+      }
+
+      if (error == TU_OKAY && submatrix)
+      {
+        violator->rows = submatrix_indices::indirect_array_type(submatrix->numRows);
+        for (int r = 0; r < submatrix->numRows; ++r)
+          violator->rows[r] = submatrix->rows[r];
+        violator->columns = submatrix_indices::indirect_array_type(submatrix->numColumns);
+        for (int c = 0; c < submatrix->numColumns; ++c)
+          violator->columns[c] = submatrix->columns[c];
+        TUsubmatFree(tu, &submatrix);
+      }
+      if (library_matrix)
+        TUchrmatFree(tu, &library_matrix);
+      TUfreeEnvironment(&tu);
+
+      if (error == TU_ERROR_MEMORY)
+        throw std::bad_alloc();
+      else if (error != TU_OKAY)
+        throw std::runtime_error("Total unimodularity test of the C library failed.");
+
+      return is_tu;
+    }
+
+    /**
+     * Tests a matrix for total unimodularity and searches for a violator if it is not totally unimodular.
+     * The decomposition tree is only constructed if it is requested.
+     *
+     * @param matrix The matrix to be tested
+     * @param decomposition Returns the root of the decomposition tree if not NULL
+     * @param violator Returns violator indices
+     * @param level Log level
+     * @return true if and only if the matrix is totally unimodular
+     */
+
+    static bool test_total_unimodularity(const integer_matrix& matrix, decomposed_matroid** decomposition,
+        submatrix_indices& violator, log_level level)
+    {
+      logger log(level);
+
+      if (log.is_progressive())
+      {
+        log.line() << "(" << matrix.size1() << " x " << matrix.size2() << ")";
+        std::cout << log;
+      }
+
+      /// Test for being a -1,0,+1 matrix
+      std::pair <integer_matrix::size_type, integer_matrix::size_type> entry;
+      if (!is_zero_plus_minus_one_matrix(matrix, entry))
+      {
+        if (log.is_progressive())
+        {
+          log.line() << " NOT -1/0/+1";
+          std::cout << log << std::endl;
+        }
+        else if (log.is_verbose())
+        {
+          std::cout << "Given " << matrix.size1() << " x " << matrix.size2() << " matrix does not contain only -1,0 and +1 entries." << std::endl;
+        }
+
+        violator.rows = submatrix_indices::indirect_array_type(1);
+        violator.rows[0] = entry.first;
+        violator.columns = submatrix_indices::indirect_array_type(1);
+        violator.columns[0] = entry.second;
+        if (decomposition)
+          *decomposition = NULL;
+        return false;
+      }
+
+      if (log.is_progressive())
+      {
+        log.line() << " -1/0/+1 OK";
+        std::cout << log;
+      }
+      else if (log.is_verbose())
+      {
+        std::cout << "Given " << matrix.size1() << " x " << matrix.size2() << " matrix contains only -1,0 and +1 entries." << std::endl;
+      }
+
+      /// Signing test
+      bool signResult = is_signed_matrix(matrix, violator);
+      if (!signResult)
+      {
+        if (log.is_progressive())
+        {
+          log.line() << ", SIGNING FAILED\n";
+          std::cout << log << std::endl;
+        }
+        else if (log.is_verbose())
+        {
+          std::cout << "The matrix is not its signed version." << std::endl;
+        }
+
+        if (decomposition)
+          *decomposition = NULL;
+        assert (violator.rows.size() == violator.columns.size());
+        return false;
+      }
+
+      if (log.is_progressive())
+      {
+        log.clear();
+        std::cout << ", SIGNING OK" << std::endl;
+      }
+      else if (log.is_verbose())
+      {
+        std::cout << "The matrix is its signed version.\n" << std::endl;
+      }
+
+      /// Decomposition of matroid represented by support matrix
+      integer_matrix worker_matrix;
+      if (matrix.size1() < matrix.size2())
+        worker_matrix = matrix;
+      else
+      {
+        if (log.is_verbose())
+        {
+          std::cout << "Working on transposed matrix. Graphs and cographs are interchanged!\n" << std::endl;
+        }
+        worker_matrix = make_transposed_matrix(matrix);
+      }
+
+      integer_matroid worker_matroid(worker_matrix.size1(), worker_matrix.size2());
+      support_matrix(worker_matrix);
+      std::pair <bool, decomposed_matroid*> result = decompose_binary_matroid(worker_matroid, worker_matrix,
+          matroid_element_set(), decomposition != NULL, log);
+      if (decomposition)
+        *decomposition = result.second;
+      if (result.first)
+        return true;
+
+      matroid_element_set rows, columns;
+      for (std::size_t r = 0; r < matrix.size1(); ++r)
+        rows.insert(-1 - r);
+      for (std::size_t c = 0; c < matrix.size2(); ++c)
+        columns.insert(1 + c);
+
+      detail::violator_strategy* strategy = new detail::greedy_violator_strategy(matrix, rows, columns, log);
+
+      strategy->search();
+      strategy->create_matrix(violator);
+
+      delete strategy;
+
+      assert (violator.rows.size() == violator.columns.size());
+
+      return false;
+    }
+  } /* namespace detail */
+
+  /**
+   * Sets the number of threads, including the calling one, that the tests called from the calling thread may use.
+   *
+   * @param num_threads Number of threads; values below 1 are treated as 1
+   */
+
+  void set_num_threads(size_t num_threads)
+  {
+    detail::own_thread_budget().idle = std::max <size_t>(num_threads, 1) - 1;
+  }
+
   /**
    * Returns a decomposition of a given binary matroid into a k-sum-decomposition (k=1,2,3)
    * in graphic, cographic, R10 and maybe irregular components.
@@ -80,6 +340,26 @@ namespace tu
       std::cout << "Given " << matrix.size1() << " x " << matrix.size2() << " matrix contains only -1,0 and +1 entries." << std::endl;
     }
 
+    if (log.is_quiet())
+    {
+      /// Signing test and decomposition of the matroid represented by the support matrix run concurrently.
+      integer_matrix worker_matrix;
+      if (matrix.size1() < matrix.size2())
+        worker_matrix = matrix;
+      else
+        worker_matrix = make_transposed_matrix(matrix);
+
+      integer_matroid worker_matroid(worker_matrix.size1(), worker_matrix.size2());
+      support_matrix(worker_matrix);
+
+      std::atomic <bool> cancelled(false);
+      bool results[2] = { false, false };
+      detail::signing_and_decomposition tasks = { matrix, worker_matroid, worker_matrix, log, cancelled, results };
+      detail::run_tasks(2, tasks);
+
+      return results[0] && results[1];
+    }
+
     /// Signing test
     bool signResult = is_signed_matrix(matrix);
     if (!signResult)
@@ -255,111 +535,7 @@ namespace tu
 
   bool is_totally_unimodular(const integer_matrix& matrix, decomposed_matroid*& decomposition, submatrix_indices& violator, log_level level)
   {
-    logger log(level);
-
-    if (log.is_progressive())
-    {
-      log.line() << "(" << matrix.size1() << " x " << matrix.size2() << ")";
-      std::cout << log;
-    }
-
-    /// Test for being a -1,0,+1 matrix
-    std::pair <integer_matrix::size_type, integer_matrix::size_type> entry;
-    if (!is_zero_plus_minus_one_matrix(matrix, entry))
-    {
-      if (log.is_progressive())
-      {
-        log.line() << " NOT -1/0/+1";
-        std::cout << log << std::endl;
-      }
-      else if (log.is_verbose())
-      {
-        std::cout << "Given " << matrix.size1() << " x " << matrix.size2() << " matrix does not contain only -1,0 and +1 entries." << std::endl;
-      }
-
-      violator.rows = submatrix_indices::indirect_array_type(1);
-      violator.rows[0] = entry.first;
-      violator.columns = submatrix_indices::indirect_array_type(1);
-      violator.columns[0] = entry.second;
-      decomposition = NULL;
-      return false;
-    }
-
-    if (log.is_progressive())
-    {
-      log.line() << " -1/0/+1 OK";
-      std::cout << log;
-    }
-    else if (log.is_verbose())
-    {
-      std::cout << "Given " << matrix.size1() << " x " << matrix.size2() << " matrix contains only -1,0 and +1 entries." << std::endl;
-    }
-
-    /// Signing test
-    bool signResult = is_signed_matrix(matrix, violator);
-    if (!signResult)
-    {
-      if (log.is_progressive())
-      {
-        log.line() << ", SIGNING FAILED\n";
-        std::cout << log << std::endl;
-      }
-      else if (log.is_verbose())
-      {
-        std::cout << "The matrix is not its signed version." << std::endl;
-      }
-
-      decomposition = NULL;
-      assert (violator.rows.size() == violator.columns.size());
-      return false;
-    }
-
-    if (log.is_progressive())
-    {
-      log.clear();
-      std::cout << ", SIGNING OK" << std::endl;
-    }
-    else if (log.is_verbose())
-    {
-      std::cout << "The matrix is its signed version.\n" << std::endl;
-    }
-
-    /// Decomposition of matroid represented by support matrix
-    integer_matrix worker_matrix;
-    if (matrix.size1() < matrix.size2())
-      worker_matrix = matrix;
-    else
-    {
-      if (log.is_verbose())
-      {
-        std::cout << "Working on transposed matrix. Graphs and cographs are interchanged!\n" << std::endl;
-      }
-      worker_matrix = make_transposed_matrix(matrix);
-    }
-
-    integer_matroid worker_matroid(worker_matrix.size1(), worker_matrix.size2());
-    support_matrix(worker_matrix);
-    bool is_tu;
-    boost::tie(is_tu, decomposition) = decompose_binary_matroid(worker_matroid, worker_matrix, matroid_element_set(), true, log);
-    if (is_tu)
-      return true;
-
-    matroid_element_set rows, columns;
-    for (std::size_t r = 0; r < matrix.size1(); ++r)
-      rows.insert(-1 - r);
-    for (std::size_t c = 0; c < matrix.size2(); ++c)
-      columns.insert(1 + c);
-
-    detail::violator_strategy* strategy = new detail::greedy_violator_strategy(matrix, rows, columns, log);
-
-    strategy->search();
-    strategy->create_matrix(violator);
-
-    delete strategy;
-
-    assert (violator.rows.size() == violator.columns.size());
-
-    return false;
+    return detail::test_total_unimodularity(matrix, &decomposition, violator, level);
   }
 
   /**
@@ -377,13 +553,37 @@ namespace tu
 
   bool is_totally_unimodular(const integer_matrix& matrix, submatrix_indices& violator, log_level level)
   {
-    decomposed_matroid* decomposition;
+    return detail::test_total_unimodularity(matrix, NULL, violator, level);
+  }
 
-    bool is_tu = is_totally_unimodular(matrix, decomposition, violator, level);
+  /**
+   * Tests a sparse matrix for total unimodularity without certificates.
+   * The matrix stays sparse for the -1,0,+1 test, the 1-sum decomposition,
+   * the signing test and the graphicness tests. Only components which are
+   * neither graphic nor cographic are decomposed in a dense binary form.
+   *
+   * @param matrix The matrix to be tested
+   * @return true if and only if the matrix is totally unimodular
+   */
 
-    delete decomposition;
+  bool is_totally_unimodular(const SparseMatrix <char>& matrix)
+  {
+    return detail::test_sparse_total_unimodularity(matrix, NULL);
+  }
 
-    return is_tu;
+  /**
+   * Tests a sparse matrix for total unimodularity with a negative certificate.
+   * If the matrix does not have this property, the routine returns the indices
+   * of a violating submatrix.
+   *
+   * @param matrix The matrix to be tested
+   * @param violator Returns violator indices
+   * @return true if and only if the matrix is totally unimodular
+   */
+
+  bool is_totally_unimodular(const SparseMatrix <char>& matrix, submatrix_indices& violator)
+  {
+    return detail::test_sparse_total_unimodularity(matrix, &violator);
   }
 
   /**
@@ -396,15 +596,7 @@ namespace tu
 
   bool is_signed_matrix(const integer_matrix& matrix)
   {
-    if (matrix.size2() > matrix.size1())
-    {
-      const matrix_transposed <const integer_matrix> transposed(matrix);
-      return sign_matrix(transposed, NULL);
-    }
-    else
-    {
-      return sign_matrix(matrix, NULL);
-    }
+    return detail::is_signed_matrix(matrix, NULL);
   }
 
   /**
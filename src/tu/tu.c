@@ -1,30 +1,237 @@
 #include <tu/tu.h>
+#include <tu/graphic.h>
 
+#include "env_internal.h"
 #include "matrix_internal.h"
 #include "one_sum.h"
+#include "regular_binary.h"
+#include "regular_internal.h"
 #include "sign_internal.h"
 
 #include <stdlib.h>
 #include <assert.h>
 
+/**
+ * \brief Compares two pointers to 1-sum components by their number of nonzeros.
+ */
+
+static
+int compareOneSumComponentPointers(const void* a, const void* b)
+{
+  return (*(TU_ONESUM_COMPONENT**)a)->matrix->numNonzeros -
+    (*(TU_ONESUM_COMPONENT**)b)->matrix->numNonzeros;
+}
+
+/**
+ * \brief Frees the data of all 1-sum components and the components array itself.
+ *
+ * Matrices, transposes and row maps that were handed over to a decomposition tree are set to \c NULL and are skipped.
+ */
+
+static
+TU_ERROR freeOneSumComponents(
+  TU* tu,                           /**< \ref TU environment. */
+  int numComponents,                /**< Number of 1-connected components. */
+  TU_ONESUM_COMPONENT** pcomponents /**< Pointer to 1-sum decomposition. */
+)
+{
+  TU_ONESUM_COMPONENT* components = *pcomponents;
+  for (int c = 0; c < numComponents; ++c)
+  {
+    if (components[c].matrix)
+      TU_CALL( TUchrmatFree(tu, (TU_CHRMAT**) &components[c].matrix) );
+    if (components[c].transpose)
+      TU_CALL( TUchrmatFree(tu, (TU_CHRMAT**) &components[c].transpose) );
+    if (components[c].rowsToOriginal)
+      TU_CALL( TUfreeBlockArray(tu, &components[c].rowsToOriginal) );
+    if (components[c].columnsToOriginal)
+      TU_CALL( TUfreeBlockArray(tu, &components[c].columnsToOriginal) );
+  }
+  TU_CALL( TUfreeBlockArray(tu, pcomponents) );
+
+  return TU_OKAY;
+}
+
+/**
+ * \brief Translates a submatrix of a 1-sum component into one of the whole matrix.
+ */
+
+static
+void translateComponentSubmatrix(
+  TU_ONESUM_COMPONENT* component, /**< 1-sum component. */
+  TU_SUBMAT* submatrix            /**< Submatrix of \p component's matrix. */
+)
+{
+  for (int r = 0; r < submatrix->numRows; ++r)
+    submatrix->rows[r] = component->rowsToOriginal[submatrix->rows[r]];
+  for (int c = 0; c < submatrix->numColumns; ++c)
+    submatrix->columns[c] = component->columnsToOriginal[submatrix->columns[c]];
+  TUsortSubmatrix(submatrix);
+}
+
+/**
+ * \brief Tests a single signed 1-connected component for regularity of its support matroid.
+ *
+ * The component is first tested for being graphic and cographic. Only if it is neither, it is decomposed into 2- and
+ * 3-sums of graphic, cographic and R10 components.
+ *
+ * If \p dec is not \c NULL, its flags are set accordingly and the graph and cograph are stored (if they exist). The
+ * decomposition of components that are neither graphic nor cographic is not stored in \p dec.
+ *
+ * If the calling task gets cancelled during a (co)graphicness test, it returns without setting *\p pisRegular.
+ */
+
+static
+TU_ERROR testRegularComponent(
+  TU* tu,                   /**< \ref TU environment. */
+  TU_ONESUM_COMPONENT* component, /**< 1-sum component to be tested. */
+  bool* pisRegular,         /**< Pointer for storing whether the component's support matroid is regular. */
+  TU_DEC* dec,              /**< Decomposition tree node for this component (may be \c NULL). */
+  TU_SUBMAT** psubmatrix    /**< Pointer for storing a bad submatrix with a bad determinant (may be \c NULL). */
+)
+{
+  TU_CHRMAT* matrix = (TU_CHRMAT*) component->matrix;
+  TU_CHRMAT* transpose = (TU_CHRMAT*) component->transpose;
+
+  TUdbgMsg(2, "Testing %dx%d component with %d nonzeros for regularity.\n", matrix->numRows, matrix->numColumns,
+    matrix->numNonzeros);
+
+  bool isGraphic;
+  TU_CALL( TUtestBinaryGraphic(tu, transpose, &isGraphic, dec ? &dec->graph : NULL, NULL, NULL, NULL) );
+  if (TUtasksCancelled(tu))
+    return TU_OKAY;
+  TUdbgMsg(4, "Component is %sgraphic.\n", isGraphic ? "" : "not ");
+
+  bool isCographic = false;
+  if (!isGraphic || dec)
+  {
+    TU_CALL( TUtestBinaryGraphic(tu, matrix, &isCographic, dec ? &dec->cograph : NULL, NULL, NULL, NULL) );
+    if (TUtasksCancelled(tu))
+      return TU_OKAY;
+    TUdbgMsg(4, "Component is %scographic.\n", isCographic ? "" : "not ");
+  }
+
+  if (isGraphic || isCographic)
+    *pisRegular = true;
+  else
+  {
+    /* Within concurrent tasks, the other threads of the environment are busy. */
+    TU_CALL( testRegularBinary(tu, matrix, tu->taskPool ? 1 : tu->numThreads, pisRegular, psubmatrix) );
+    TUdbgMsg(4, "Component is %sregular.\n", *pisRegular ? "" : "not ");
+  }
+
+  if (dec)
+  {
+    if (isGraphic)
+      dec->flags |= TU_DEC_GRAPHIC | TU_DEC_PROCESSED;
+    if (isCographic)
+      dec->flags |= TU_DEC_COGRAPHIC | TU_DEC_PROCESSED;
+    if (*pisRegular)
+      dec->flags |= TU_DEC_REGULAR;
+  }
+
+  return TU_OKAY;
+}
+
+/**
+ * \brief Result of testing a single 1-connected component.
+ */
+
+typedef struct
+{
+  TU_ONESUM_COMPONENT* component; /**< \brief The component. */
+  bool tested;                    /**< \brief Whether the component was tested (and not skipped or cancelled). */
+  bool signsCorrect;              /**< \brief Whether the component is its own signed version. */
+  bool isRegular;                 /**< \brief Whether the support matroid of the component is regular. */
+  TU_DEC* dec;                    /**< \brief Decomposition tree node of the component or \c NULL. */
+  TU_SUBMAT* submatrix;           /**< \brief Submatrix of the component with a bad determinant or \c NULL. */
+} COMPONENT_TEST;
+
+/**
+ * \brief Data shared by all component tasks of \ref testTotalUnimodularityOneSum.
+ */
+
+typedef struct
+{
+  COMPONENT_TEST* tests;          /**< \brief Array with one entry per component, ordered by size. */
+  bool constructDecomposition;    /**< \brief Whether decomposition tree nodes shall be created. */
+  bool computeSubmatrix;          /**< \brief Whether a bad submatrix shall be searched. */
+} COMPONENT_TEST_DATA;
+
+/**
+ * \brief Task that tests a single component for correct signs and regularity.
+ *
+ * Requests cancellation of the remaining tasks if the component is not TU, unless a decomposition tree is constructed.
+ * A wrong sign always leads to cancellation. The signing and (co)graphicness tests of a running task stop as soon as
+ * another task requested cancellation, in which case the task returns without a result.
+ */
+
+static
+TU_ERROR testComponentTask(
+  TU* tu,       /**< \ref TU environment of the executing thread. */
+  int task,     /**< Index of the component in the ordered array. */
+  void* data,   /**< Pointer to \ref COMPONENT_TEST_DATA. */
+  bool* pcancel /**< Pointer for requesting cancellation. */
+)
+{
+  COMPONENT_TEST_DATA* testData = (COMPONENT_TEST_DATA*) data;
+  COMPONENT_TEST* test = &testData->tests[task];
+  TU_ONESUM_COMPONENT* component = test->component;
+
+  /* Check correct signing. */
+
+  char modification;
+  TU_CALL( signSequentiallyConnected(tu, (TU_CHRMAT*) component->matrix, (TU_CHRMAT*) component->transpose, false,
+    &modification, testData->computeSubmatrix ? &test->submatrix : NULL) );
+  if (modification)
+  {
+    test->tested = true;
+    test->signsCorrect = false;
+    *pcancel = true;
+    return TU_OKAY;
+  }
+  if (TUtasksCancelled(tu))
+    return TU_OKAY;
+
+  /* Check regularity. */
+
+  if (testData->constructDecomposition)
+    TU_CALL( TUcreateDec(tu, &test->dec) );
+  TU_CALL( testRegularComponent(tu, component, &test->isRegular, test->dec,
+    testData->computeSubmatrix ? &test->submatrix : NULL) );
+  if (TUtasksCancelled(tu))
+    return TU_OKAY;
+  test->tested = true;
+  if (!test->isRegular && !testData->constructDecomposition)
+    *pcancel = true;
+
+  return TU_OKAY;
+}
 
 /**
  * \brief Tests the 1-sum of char matrices for total unimodularity.
  *
- * Returns \c true if and only if the 1-sum of the given \p components is TU.
+ * Sets *\p pisTU to \c true if and only if the 1-sum of the given \p components is TU. The components are processed
+ * from the smallest to the largest one (w.r.t. their number of nonzeros), concurrently if the environment uses
+ * several threads. Each component is tested for correct signs first and then for regularity of its support matroid.
+ * Unless a decomposition tree is requested, no further components are started once a component is not TU.
  *
- * If \p pdecomposition is not \c NULL and the algorithm has to test regularity of the support matrix, then
- * \c *pdecomposition will point to a decomposition tree for which the caller must use \ref TUdecFree to free memory.
+ * If \p pdec is not \c NULL and the algorithm has to test regularity of the support matrix, then
+ * \c *pdec will point to a decomposition tree for which the caller must use \ref TUdecFree to free memory.
  * It is set to \c NULL in case regularity of the support matrix does not need to be determined.
  *
  * If \p psubmatrix is not \c NULL and the matrix is not TU, then a submatrix with an absolute determinant larger than
  * 1 will be searched, which may cause extra computational effort. In this case, *\p psubmatrix will point to this
- * submatrix for which the caller must use \ref TUsubmatFree to free memory. It is set to \c NULL otherwise.
+ * submatrix for which the caller must use \ref TUsubmatFree to free memory. It is set to \c NULL otherwise. The
+ * submatrix belongs to the smallest tested component that is not TU.
+ *
+ * The components are freed afterwards.
  */
 
 static
 TU_ERROR testTotalUnimodularityOneSum(
   TU* tu,                           /**< \ref TU environment. */
+  TU_CHRMAT* matrix,                /**< Signed support of the whole matrix, needed only if \p pdec is not \c NULL. */
   int numComponents,                /**< Number of 1-connected components. */
   TU_ONESUM_COMPONENT* components,  /**< 1-sum decomposition of matrix to be tested. */
   bool* pisTU,                      /**< Pointer for storing whether matrix is TU.*/
@@ -33,192 +240,234 @@ TU_ERROR testTotalUnimodularityOneSum(
 )
 {
   assert(numComponents >= 0);
-  assert(components);
+  assert(components || numComponents == 0);
+  assert(!pdec || matrix);
 
   /* Sort components by number of nonzeros. */
 
-  /* Check each component for base cases first. If enabled, ask for forbidden minors. */
+  TU_ONESUM_COMPONENT** orderedComponents = NULL;
+  TU_CALL( TUallocStackArray(tu, &orderedComponents, numComponents) );
+  for (int comp = 0; comp < numComponents; ++comp)
+    orderedComponents[comp] = &components[comp];
+  qsort(orderedComponents, numComponents, sizeof(TU_ONESUM_COMPONENT*), &compareOneSumComponentPointers);
 
-  /* Check non-base cases by decomposing, using information about minors. If enabled, ask for
-     rows/columns that cause irregularity. */
+  /* Test the components, possibly in parallel. */
 
-  /* If not regular and submatrix is required, start search in smallest non-regular component. */
+  COMPONENT_TEST_DATA data;
+  data.tests = NULL;
+  data.constructDecomposition = pdec != NULL;
+  data.computeSubmatrix = psubmatrix != NULL;
+  TU_CALL( TUallocBlockArray(tu, &data.tests, numComponents) );
+  for (int i = 0; i < numComponents; ++i)
+  {
+    data.tests[i].component = orderedComponents[i];
+    data.tests[i].tested = false;
+    data.tests[i].signsCorrect = true;
+    data.tests[i].isRegular = true;
+    data.tests[i].dec = NULL;
+    data.tests[i].submatrix = NULL;
+  }
+  TU_CALL( TUfreeStackArray(tu, &orderedComponents) );
 
-  assert("TU test not implemented, yet." == 0);
+  TU_CALL( TUrunTasks(tu, numComponents, &testComponentTask, &data, NULL) );
 
-  for (int c = 0; c < numComponents; ++c)
+  /* Collect the results in the order of the components. */
+
+  *pisTU = true;
+  bool signsCorrect = true;
+  for (int i = 0; i < numComponents; ++i)
   {
-    TUchrmatFree(tu, (TU_CHRMAT**) &components[c].matrix);
-    TUchrmatFree(tu, (TU_CHRMAT**) &components[c].transpose);
-    TUfreeBlockArray(tu, &components[c].rowsToOriginal);
-    TUfreeBlockArray(tu, &components[c].columnsToOriginal);
+    COMPONENT_TEST* test = &data.tests[i];
+    if (!test->signsCorrect)
+      signsCorrect = false;
+    if (!test->signsCorrect || !test->isRegular)
+      *pisTU = false;
+
+    if (test->submatrix)
+    {
+      if (*psubmatrix)
+        TU_CALL( TUsubmatFree(tu, &test->submatrix) );
+      else
+      {
+        translateComponentSubmatrix(test->component, test->submatrix);
+        *psubmatrix = test->submatrix;
+      }
+    }
+  }
+
+  if (pdec)
+  {
+    /* A wrong sign means that regularity of the support matrix is irrelevant. */
+
+    if (signsCorrect)
+    {
+      TU_DEC* root = NULL;
+      if (numComponents == 1)
+        root = data.tests[0].dec;
+      else
+      {
+        TU_CALL( TUcreateDec(tu, &root) );
+        root->flags = TU_DEC_PROCESSED | TU_DEC_GRAPHIC | TU_DEC_COGRAPHIC | TU_DEC_REGULAR;
+        TU_CALL( TUchrmatCopy(tu, matrix, &root->matrix) );
+        TU_CALL( TUchrmatTranspose(tu, matrix, &root->transpose) );
+      }
+      if (numComponents > 1)
+      {
+        root->flags |= TU_DEC_ONE_SUM;
+        root->numChildren = numComponents;
+        TU_CALL( TUallocBlockArray(tu, &root->children, numComponents) );
+      }
+
+      for (int i = 0; i < numComponents; ++i)
+      {
+        COMPONENT_TEST* test = &data.tests[i];
+        TU_DEC* child = test->dec;
+        assert(child);
+
+        /* Hand over the component's matrices and use the original indices as labels. */
+        child->matrix = (TU_CHRMAT*) test->component->matrix;
+        child->transpose = (TU_CHRMAT*) test->component->transpose;
+        child->rowLabels = test->component->rowsToOriginal;
+        child->columnLabels = test->component->columnsToOriginal;
+        test->component->matrix = NULL;
+        test->component->transpose = NULL;
+        test->component->rowsToOriginal = NULL;
+        test->component->columnsToOriginal = NULL;
+
+        if (child != root)
+        {
+          root->children[i] = child;
+          root->flags &= child->flags | ~(TU_DEC_GRAPHIC | TU_DEC_COGRAPHIC | TU_DEC_REGULAR);
+        }
+      }
+      *pdec = root;
+    }
+    else
+    {
+      for (int i = 0; i < numComponents; ++i)
+      {
+        if (data.tests[i].dec)
+          TUdecFree(tu, &data.tests[i].dec);
+      }
+    }
   }
 
+  TU_CALL( TUfreeBlockArray(tu, &data.tests) );
+  TU_CALL( freeOneSumComponents(tu, numComponents, &components) );
+
   return TU_OKAY;
 }
 
+/**
+ * \brief Tests a ternary matrix for total unimodularity.
+ *
+ * The \p matrix (with entries of size \p matrixType) is decomposed into 1-connected components which are tested by
+ * \ref testTotalUnimodularityOneSum. The signed support \p support is only needed if \p pdec is not \c NULL.
+ */
+
+static
+TU_ERROR testTotalUnimodularityTernary(
+  TU* tu,                 /**< \ref TU environment. */
+  TU_MATRIX* matrix,      /**< Ternary matrix. */
+  size_t matrixType,      /**< Size of base type of \p matrix. */
+  TU_CHRMAT* support,     /**< Signed support of \p matrix (may be \c NULL if \p pdec is \c NULL). */
+  bool* pisTU,            /**< Pointer for storing whether \p matrix is TU.*/
+  TU_DEC** pdec,          /**< Pointer for storing the decomposition tree (may be \c NULL). */
+  TU_SUBMAT** psubmatrix  /**< Pointer for storing a bad submatrix with a bad determinant (may be \c NULL). */
+)
+{
+  int numComponents;
+  TU_ONESUM_COMPONENT* components = NULL;
+
+  /* Perform 1-sum decomposition. */
+
+  TU_CALL( decomposeOneSum(tu, matrix, matrixType, sizeof(char), &numComponents, &components, NULL, NULL, NULL,
+    NULL) );
+
+  /* Check signing and regularity for each component. */
+
+  return testTotalUnimodularityOneSum(tu, support, numComponents, components, pisTU, pdec, psubmatrix);
+}
+
 TU_ERROR TUtestTotalUnimodularityDbl(TU* tu, TU_DBLMAT* matrix, double epsilon, bool* pisTU, TU_DEC** pdec,
   TU_SUBMAT** psubmatrix)
 {
   assert(tu);
   assert(matrix);
+  assert(pisTU);
+  assert(!psubmatrix || !*psubmatrix);
 
-  int numComponents;
-  TU_ONESUM_COMPONENT* components;
+  if (pdec)
+    *pdec = NULL;
 
   /* Check entries. */
 
   if (!TUisTernaryDbl(tu, matrix, epsilon, psubmatrix))
-    return false;
-
-  /* Perform 1-sum decomposition. */
-
-  decomposeOneSum(tu, (TU_MATRIX*) matrix, sizeof(double), sizeof(char), &numComponents,
-    &components, NULL, NULL, NULL, NULL);
-
-  /* Check correct signing for each component. */
-
-  for (int comp = 0; comp < numComponents; ++comp)
   {
-    TU_SUBMAT* compSubmatrix;
-    char modification;
-    TU_CALL( signSequentiallyConnected(tu, (TU_CHRMAT*) &components[comp].matrix,
-      (TU_CHRMAT*) &components[comp].transpose, false, &modification, psubmatrix ? &compSubmatrix : NULL) );
+    *pisTU = false;
+    return TU_OKAY;
+  }
 
-    if (modification)
-    {
-      if (psubmatrix)
-      {
-        /* Translate component indices to indices of whole matrix and sort them again. */
-        for (int r = 0; r < compSubmatrix->numRows; ++r)
-          compSubmatrix->rows[r] = components[comp].rowsToOriginal[compSubmatrix->rows[r]];
-        for (int c = 0; c < compSubmatrix->numColumns; ++c)
-          compSubmatrix->columns[c] = components[comp].columnsToOriginal[compSubmatrix->columns[c]];
-        TUsortSubmatrix(compSubmatrix);
-        *psubmatrix = compSubmatrix;
-      }
+  TU_CHRMAT* support = NULL;
+  if (pdec)
+    TU_CALL( TUsignedSupportDbl(tu, matrix, epsilon, &support) );
 
-      for (int c = 0; c < numComponents; ++c)
-      {
-        TUchrmatFree(tu, (TU_CHRMAT**) &components[c].matrix);
-        TUchrmatFree(tu, (TU_CHRMAT**) &components[c].transpose);
-        TUfreeBlockArray(tu, &components[c].rowsToOriginal);
-        TUfreeBlockArray(tu, &components[c].columnsToOriginal);
-      }
+  TU_CALL( testTotalUnimodularityTernary(tu, (TU_MATRIX*) matrix, sizeof(double), support, pisTU, pdec,
+    psubmatrix) );
 
-      return false;
-    }
-  }
+  if (support)
+    TU_CALL( TUchrmatFree(tu, &support) );
 
-  return testTotalUnimodularityOneSum(tu, numComponents, components, pisTU, pdec, psubmatrix);
+  return TU_OKAY;
 }
 
 TU_ERROR TUtestTotalUnimodularityInt(TU* tu, TU_INTMAT* matrix, bool* pisTU, TU_DEC** pdec, TU_SUBMAT** psubmatrix)
 {
   assert(tu);
   assert(matrix);
+  assert(pisTU);
+  assert(!psubmatrix || !*psubmatrix);
 
-  int numComponents;
-  TU_ONESUM_COMPONENT* components;
+  if (pdec)
+    *pdec = NULL;
 
   /* Check entries. */
 
   if (!TUisTernaryInt(tu, matrix, psubmatrix))
-    return false;
-
-  /* Perform 1-sum decomposition. */
-
-  TU_CALL( decomposeOneSum(tu, (TU_MATRIX*) matrix, sizeof(int), sizeof(char), &numComponents, &components, NULL, NULL,
-    NULL, NULL) );
-
-  /* Check correct signing for each component. */
-
-  for (int comp = 0; comp < numComponents; ++comp)
   {
-    TU_SUBMAT* compSubmatrix;
-    char modified;
-    TU_CALL( signSequentiallyConnected(tu, (TU_CHRMAT*) &components[comp].matrix,
-      (TU_CHRMAT*) &components[comp].transpose, false, &modified, psubmatrix ? &compSubmatrix : NULL) );
+    *pisTU = false;
+    return TU_OKAY;
+  }
 
-    if (modified)
-    {
-      if (psubmatrix)
-      {
-        /* Translate component indices to indices of whole matrix and sort them again. */
-        for (int r = 0; r < compSubmatrix->numRows; ++r)
-          compSubmatrix->rows[r] = components[comp].rowsToOriginal[compSubmatrix->rows[r]];
-        for (int c = 0; c < compSubmatrix->numColumns; ++c)
-          compSubmatrix->columns[c] = components[comp].columnsToOriginal[compSubmatrix->columns[c]];
-        TUsortSubmatrix(compSubmatrix);
-        *psubmatrix = compSubmatrix;
-      }
+  TU_CHRMAT* support = NULL;
+  if (pdec)
+    TU_CALL( TUsignedSupportInt(tu, matrix, &support) );
 
-      for (int c = 0; c < numComponents; ++c)
-      {
-        TUchrmatFree(tu, (TU_CHRMAT**) &components[c].matrix);
-        TUchrmatFree(tu, (TU_CHRMAT**) &components[c].transpose);
-        TUfreeBlockArray(tu, &components[c].rowsToOriginal);
-        TUfreeBlockArray(tu, &components[c].columnsToOriginal);
-      }
+  TU_CALL( testTotalUnimodularityTernary(tu, (TU_MATRIX*) matrix, sizeof(int), support, pisTU, pdec, psubmatrix) );
 
-      return false;
-    }
-  }
+  if (support)
+    TU_CALL( TUchrmatFree(tu, &support) );
 
-  return testTotalUnimodularityOneSum(tu, numComponents, components, pisTU, pdec, psubmatrix);
+  return TU_OKAY;
 }
 
 TU_ERROR TUtestTotalUnimodularityChr(TU* tu, TU_CHRMAT* matrix, bool* pisTU, TU_DEC** pdec, TU_SUBMAT** psubmatrix)
 {
   assert(tu);
   assert(matrix);
+  assert(pisTU);
+  assert(!psubmatrix || !*psubmatrix);
 
-  int numComponents;
-  TU_ONESUM_COMPONENT* components;
+  if (pdec)
+    *pdec = NULL;
 
   /* Check entries. */
 
   if (!TUisTernaryChr(tu, matrix, psubmatrix))
-    return false;
-
-  /* Perform 1-sum decomposition. */
-
-  TU_CALL( decomposeOneSum(tu, (TU_MATRIX*) matrix, sizeof(char), sizeof(char), &numComponents, &components, NULL, NULL,
-    NULL, NULL) );
-
-  /* Check correct signing for each component. */
-
-  for (int comp = 0; comp < numComponents; ++comp)
   {
-    TU_SUBMAT* compSubmatrix;
-    char modified;
-    signSequentiallyConnected(tu, (TU_CHRMAT*) &components[comp].matrix,
-      (TU_CHRMAT*) &components[comp].transpose, false, &modified, psubmatrix ? &compSubmatrix : NULL);
-
-    if (modified)
-    {
-      if (psubmatrix)
-      {
-        /* Translate component indices to indices of whole matrix and sort them again. */
-        for (int r = 0; r < compSubmatrix->numRows; ++r)
-          compSubmatrix->rows[r] = components[comp].rowsToOriginal[compSubmatrix->rows[r]];
-        for (int c = 0; c < compSubmatrix->numColumns; ++c)
-          compSubmatrix->columns[c] = components[comp].columnsToOriginal[compSubmatrix->columns[c]];
-        TUsortSubmatrix(compSubmatrix);
-        *psubmatrix = compSubmatrix;
-      }
-
-      for (int c = 0; c < numComponents; ++c)
-      {
-        TUchrmatFree(tu, (TU_CHRMAT**) &components[c].matrix);
-        TUchrmatFree(tu, (TU_CHRMAT**) &components[c].transpose);
-        TUfreeBlockArray(tu, &components[c].rowsToOriginal);
-        TUfreeBlockArray(tu, &components[c].columnsToOriginal);
-      }
-
-      return false;
-    }
+    *pisTU = false;
+    return TU_OKAY;
   }
 
-  return testTotalUnimodularityOneSum(tu, numComponents, components, pisTU, pdec, psubmatrix);
+  return testTotalUnimodularityTernary(tu, (TU_MATRIX*) matrix, sizeof(char), matrix, pisTU, pdec, psubmatrix);
 }
@@ -82,7 +82,7 @@ int run_decomposition(const std::string& file_name, bool show_certificates, tu::
     {
       std::cout << "\nThe " << matrix.size1() << " x " << matrix.size2() << " matrix is not totally unimodular." << std::endl;
       assert (violator.rows.size() == violator.columns.size());
-      int det = tu::submatrix_determinant(matrix, violator);
+      long long det = tu::submatrix_determinant(matrix, violator);
       std::cout << "\nThe violating submatrix (det = " << det << ") is " << violator.rows.size() << " x " << violator.columns.size() << ":\n\n"
           << std::flush;
       print_violator(matrix, violator);
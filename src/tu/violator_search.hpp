@@ -2,11 +2,19 @@
 
 #include <boost/numeric/ublas/matrix_proxy.hpp>
 
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+
 #include "matrix_internal.h"
 #include "algorithm.hpp"
 #include "matroid.hpp"
 #include "signing.hpp"
 #include "logger.hpp"
+#include "determinant.hpp"
+#include "parallel.hpp"
 #include <tu/total_unimodularity.hpp>
 
 namespace tu
@@ -87,6 +95,21 @@ namespace tu
 
     }
 
+    /**
+     * Base class of the searches for a small violator, i.e., a submatrix that is not totally unimodular. A search tests
+     * submatrices of the current violator and shrinks the violator to those that fail. The only knowledge kept between
+     * these tests is which removals yield totally unimodular submatrices. Each candidate gets its own signing test and
+     * its own decomposition.
+     *
+     * The signing test of the violator cannot replace those of its candidates. If the support of the violator is not
+     * regular, then a submatrix may fail the signing test although the violator passed it. A sequence of nested minors
+     * of the violator is stored in terms of its pivoted and permuted representation matrix. A removed row or column
+     * whose element was moved by a pivot can only be removed there after pivoting back, which changes all minors.
+     * Otherwise only the extensions before the first one containing a removed element stay valid. Moreover, the
+     * decomposition of a candidate starts with the graphicness, cographicness and R10 tests of the whole candidate, and
+     * a sequence does not shorten these.
+     */
+
     class violator_strategy
     {
     public:
@@ -121,30 +144,35 @@ namespace tu
 
     protected:
 
+      /**
+       * Replaces the current violator by a smaller one. The caller must have found the given submatrix to be not
+       * totally unimodular.
+       *
+       * @param row_elements Row elements of the new violator
+       * @param column_elements Column elements of the new violator
+       */
+
       virtual void shrink(const matroid_element_set& row_elements, const matroid_element_set& column_elements)
       {
-        typedef boost::numeric::ublas::matrix_indirect <const integer_matrix, submatrix_indices::indirect_array_type> indirect_matrix_t;
-
-        integer_matroid matroid;
-        submatrix_indices sub_indices;
-
-        create_indirect_matroid(_input_matrix, row_elements, column_elements, matroid, sub_indices);
-        indirect_matrix_t sub_matrix(_input_matrix, sub_indices.rows, sub_indices.columns);
-
-        if (is_totally_unimodular(sub_matrix))
-        {
-          std::cout << "submatrix is t.u., but should not:" << std::endl;
-          matrix_print(sub_matrix);
-
-          assert (false);
-        }
-
         _row_elements = row_elements;
         _column_elements = column_elements;
-
       }
 
-      inline bool test(const matroid_element_set& row_elements, const matroid_element_set& column_elements)
+      /**
+       * Tests a submatrix for total unimodularity without changing the current violator. If the submatrix is not its
+       * own signed version, then the signing test already yields a violating submatrix, which is returned instead.
+       * Otherwise only the regularity of its support matroid is decided, without constructing a decomposition.
+       *
+       * @param row_elements Row elements of the submatrix
+       * @param column_elements Column elements of the submatrix
+       * @param violator_rows Returns the row elements of a violator if the submatrix is not totally unimodular
+       * @param violator_columns Returns the column elements of a violator if the submatrix is not totally unimodular
+       * @param cancelled If not NULL, then the test stops early once this flag is set and its result is meaningless
+       * @return true if and only if the submatrix is totally unimodular
+       */
+
+      bool evaluate(const matroid_element_set& row_elements, const matroid_element_set& column_elements,
+          matroid_element_set& violator_rows, matroid_element_set& violator_columns, std::atomic <bool>* cancelled = NULL) const
       {
         typedef boost::numeric::ublas::matrix_indirect <const integer_matrix, submatrix_indices::indirect_array_type> indirect_matrix_t;
 
@@ -156,24 +184,35 @@ namespace tu
 
         /// Signing test
 
-        decomposed_matroid* decomposition;
         integer_matrix matrix(sub_matrix);
+        submatrix_indices signing_violator;
 
-        //if (_log.is_progressive() || _log.is_verbose())
-        //{
-        //  std::cout << "Testing a " << row_elements.size() << " x " << column_elements.size() << " submatrix." << std::endl;
-        //  integer_matrix M = sub_matrix;
-        //  bool result = ghouila_houri_is_totally_unimodular(M);
-        //  std::cout << "GH: " << (result ? "TU" : "non-TU" ) << std::endl;
-        //}
-
-        if (!is_signed_matrix(matrix))
+        if (!is_signed_matrix(matrix, signing_violator))
         {
           if (_log.is_progressive() || _log.is_verbose())
           {
             std::cout << "Submatrix did not pass the signing test. It is NOT totally unimodular.\n" << std::endl;
           }
-          shrink(row_elements, column_elements);
+
+          for (size_t i = 0; i < signing_violator.rows.size(); ++i)
+            violator_rows.insert(matroid.name1(signing_violator.rows[i]));
+          for (size_t i = 0; i < signing_violator.columns.size(); ++i)
+            violator_columns.insert(matroid.name2(signing_violator.columns[i]));
+          return false;
+        }
+
+        /// Square submatrices which violate Camion's criterion or have a large determinant are no further decomposed.
+        if (row_elements.size() == column_elements.size() && (!submatrix_camion(_input_matrix, sub_indices)
+            || (row_elements.size() <= max_determinant_size && has_large_determinant(sub_indices))))
+        {
+          if (_log.is_progressive() || _log.is_verbose())
+          {
+            std::cout << "\nThe " << row_elements.size() << " x " << column_elements.size()
+                << " submatrix has a determinant other than -1, 0 and +1. It is NOT totally unimodular.\n" << std::endl;
+          }
+
+          violator_rows = row_elements;
+          violator_columns = column_elements;
           return false;
         }
 
@@ -181,52 +220,54 @@ namespace tu
         support_matrix(matrix);
 
         /// Matroid decomposition
-        bool is_tu;
-        boost::tie(is_tu, decomposition) = decompose_binary_matroid(matroid, matrix, matroid_element_set(), true, _log);
-
-        if (is_tu)
+        if (decompose_binary_matroid(matroid, matrix, matroid_element_set(), false, _log, cancelled).first)
         {
           if (_log.is_progressive() || _log.is_verbose())
           {
             std::cout << "\nSubmatrix is totally unimodular.\n" << std::endl;
           }
-          delete decomposition;
           return true;
         }
 
-        /// The following part is commented because it seems to be incorrect.
-
-        
-        // matroid_element_set rows, columns, elements = detail::find_smallest_irregular_minor(decomposition);
-        delete decomposition;
- 
-        // detail::split_elements(elements.begin(), elements.end(), std::inserter(rows, rows.end()), std::inserter(columns, columns.end()));
-
         if (_log.is_progressive() || _log.is_verbose())
         {
-          // if (rows.size() < row_elements.size() || columns.size() < column_elements.size())
-          // {
-          //   std::cout << "\nThe " << row_elements.size() << " x " << column_elements.size() << " submatrix is NOT totally unimodular. A "
-          //       << rows.size() << " x " << columns.size() << " non-totally unimodular submatrix was identified, too.\n" << std::endl;
-          // }
-          // else
-          // {
-            std::cout << "\nThe " << row_elements.size() << " x " << column_elements.size() << " submatrix is NOT totally unimodular.\n" << std::endl;
-          // }
+          std::cout << "\nThe " << row_elements.size() << " x " << column_elements.size() << " submatrix is NOT totally unimodular.\n" << std::endl;
         }
 
-        //if (rows.size() < row_elements.size() || columns.size() < column_elements.size())
-        //  shrink(rows, columns);
-        //else
-          shrink(row_elements, column_elements);
+        violator_rows = row_elements;
+        violator_columns = column_elements;
+        return false;
+      }
+
+      /**
+       * Tests a submatrix for total unimodularity and shrinks the violator if it is not.
+       *
+       * @param row_elements Row elements of the submatrix
+       * @param column_elements Column elements of the submatrix
+       * @return true if and only if the submatrix is totally unimodular
+       */
+
+      inline bool test(const matroid_element_set& row_elements, const matroid_element_set& column_elements)
+      {
+        matroid_element_set violator_rows, violator_columns;
+        if (evaluate(row_elements, column_elements, violator_rows, violator_columns))
+          return true;
 
+        shrink(violator_rows, violator_columns);
         return false;
       }
 
-      inline bool test_forbidden(const matroid_element_set& forbidden_elements)
+      /**
+       * Computes the rows and columns of the current violator which are not forbidden.
+       *
+       * @param forbidden_elements Elements to be removed
+       * @param rows Returns the remaining row elements
+       * @param columns Returns the remaining column elements
+       */
+
+      void remove_forbidden(const matroid_element_set& forbidden_elements, matroid_element_set& rows,
+          matroid_element_set& columns) const
       {
-        /// Setup rows and columns
-        matroid_element_set rows, columns;
         for (matroid_element_set::const_iterator iter = _row_elements.begin(); iter != _row_elements.end(); ++iter)
         {
           if (forbidden_elements.find(*iter) == forbidden_elements.end())
@@ -241,15 +282,90 @@ namespace tu
             columns.insert(*iter);
           }
         }
+      }
 
-        return test(rows, columns);
+      /**
+       * Checks whether removing the given elements from the current violator is known to yield a totally unimodular
+       * submatrix. This holds if one of them alone was removed from an earlier violator with this result, since
+       * violators only shrink and submatrices of totally unimodular matrices are totally unimodular.
+       *
+       * @param forbidden_elements Elements to be removed
+       * @return true if the remaining submatrix is known to be totally unimodular
+       */
+
+      bool is_known_tu_elimination(const matroid_element_set& forbidden_elements) const
+      {
+        for (matroid_element_set::const_iterator iter = forbidden_elements.begin(); iter != forbidden_elements.end(); ++iter)
+        {
+          if (_tu_eliminations.find(*iter) != _tu_eliminations.end())
+            return true;
+        }
+        return false;
+      }
+
+      /**
+       * Records that removing the given elements from the current violator yields a totally unimodular submatrix.
+       * Only single elements are remembered.
+       *
+       * @param forbidden_elements Elements that were removed
+       */
+
+      void add_tu_elimination(const matroid_element_set& forbidden_elements)
+      {
+        if (forbidden_elements.size() == 1)
+          _tu_eliminations.insert(*forbidden_elements.begin());
+      }
+
+      inline bool test_forbidden(const matroid_element_set& forbidden_elements)
+      {
+        if (is_known_tu_elimination(forbidden_elements))
+          return true;
+
+        /// Setup rows and columns
+        matroid_element_set rows, columns;
+        remove_forbidden(forbidden_elements, rows, columns);
+
+        if (!test(rows, columns))
+          return false;
+
+        add_tu_elimination(forbidden_elements);
+        return true;
+      }
+
+      /**
+       * Computes the determinant of a square submatrix. Concurrent tests share the engine and its scratch memory.
+       *
+       * @param indices Indices of the submatrix
+       * @return true if the absolute determinant is known to be larger than 1
+       */
+
+      bool has_large_determinant(const submatrix_indices& indices) const
+      {
+        std::lock_guard <std::mutex> lock(_determinant_mutex);
+        try
+        {
+          return std::abs(_determinant(_input_matrix, indices)) > 1;
+        }
+        catch (std::overflow_error&)
+        {
+          /// The determinant is unknown, so the submatrix is decomposed.
+          return false;
+        }
       }
 
+      /// Maximal size of square submatrices whose determinant is computed. By Hadamard's bound, the determinant of a
+      /// -1/0/+1 matrix of this size is at most 24^12 < 2^63. This does not hold for the products of two minors formed
+      /// during the elimination, which need 128-bit integers; without them, the computation may fail.
+      static const size_t max_determinant_size = 24;
+
     protected:
       const integer_matrix& _input_matrix;
       matroid_element_set _row_elements;
       matroid_element_set _column_elements;
+      matroid_element_set _tu_eliminations;
       logger& _log;
+      mutable std::mutex _determinant_mutex;
+      mutable determinant_engine _determinant;
     };
 
     class single_violator_strategy: public violator_strategy
@@ -294,9 +410,19 @@ namespace tu
     class greedy_violator_strategy: public violator_strategy
     {
     public:
+      /**
+       * Constructs the strategy.
+       *
+       * @param input_matrix Matrix which is not totally unimodular
+       * @param row_elements Row elements of the initial violator
+       * @param column_elements Column elements of the initial violator
+       * @param log Logger
+       * @param seed Seed for the random order in which elements are removed
+       */
+
       greedy_violator_strategy(const integer_matrix& input_matrix, const matroid_element_set& row_elements,
-          const matroid_element_set& column_elements, logger& log) :
-        violator_strategy(input_matrix, row_elements, column_elements, log)
+          const matroid_element_set& column_elements, logger& log, std::mt19937::result_type seed = std::mt19937::default_seed) :
+        violator_strategy(input_matrix, row_elements, column_elements, log), _random_engine(seed)
       {
 
       }
@@ -311,7 +437,42 @@ namespace tu
       }
 
       /**
-       * Tests minors given in a vector of sets.
+       * Tests the minor of one bundle (task). A failed test cancels the tests of all later bundles, such that the
+       * first bundle in the given order whose minor is not totally unimodular is found.
+       */
+
+      struct bundle_tester
+      {
+        const greedy_violator_strategy& strategy;
+        const std::vector <matroid_element_set>& bundles;
+        std::vector <matroid_element_set>& violator_rows;
+        std::vector <matroid_element_set>& violator_columns;
+        std::vector <char>& results;
+        std::vector <std::atomic <bool> >& cancelled;
+        std::atomic <size_t>& first_failure;
+
+        void operator()(size_t task) const
+        {
+          if (task > first_failure || strategy.is_known_tu_elimination(bundles[task]))
+            return;
+
+          matroid_element_set rows, columns;
+          strategy.remove_forbidden(bundles[task], rows, columns);
+          results[task] = strategy.evaluate(rows, columns, violator_rows[task], violator_columns[task], &cancelled[task]);
+          if (results[task])
+            return;
+
+          size_t current = first_failure;
+          while (task < current && !first_failure.compare_exchange_weak(current, task))
+            ;
+          for (size_t t = task + 1; t < cancelled.size(); ++t)
+            cancelled[t] = true;
+        }
+      };
+
+      /**
+       * Tests minors given in a vector of sets and shrinks the violator to the first minor which is not totally
+       * unimodular. The tests run concurrently if threads are idle, unless output is logged.
        *
        * @param bundles Vector of Sets containing the removed elements.
        * @return true iff a test failed, i.e. the submatrix was not totally unimodular.
@@ -319,14 +480,34 @@ namespace tu
 
       bool test_bundles(const std::vector <matroid_element_set>& bundles)
       {
-        for (std::vector <matroid_element_set>::const_iterator bundle_iter = bundles.begin(); bundle_iter != bundles.end(); ++bundle_iter)
+        std::vector <matroid_element_set> violator_rows(bundles.size());
+        std::vector <matroid_element_set> violator_columns(bundles.size());
+        std::vector <char> results(bundles.size(), false);
+        std::vector <std::atomic <bool> > cancelled(bundles.size());
+        for (size_t i = 0; i < cancelled.size(); ++i)
+          cancelled[i] = false;
+        std::atomic <size_t> first_failure(bundles.size());
+
+        bundle_tester tester = { *this, bundles, violator_rows, violator_columns, results, cancelled, first_failure };
+        if (_log.is_quiet())
+          run_tasks(bundles.size(), tester);
+        else
         {
-          if (!test_forbidden(*bundle_iter))
-          {
-            return true;
-          }
+          for (size_t task = 0; task < bundles.size(); ++task)
+            tester(task);
         }
-        return false;
+
+        for (size_t task = 0; task < bundles.size(); ++task)
+        {
+          if (results[task])
+            add_tu_elimination(bundles[task]);
+        }
+
+        if (first_failure == bundles.size())
+          return false;
+
+        shrink(violator_rows[first_failure], violator_columns[first_failure]);
+        return true;
       }
 
       virtual void search()
@@ -359,8 +540,8 @@ namespace tu
           std::copy(_row_elements.begin(), _row_elements.end(), std::back_inserter(shuffled_rows));
           std::copy(_column_elements.begin(), _column_elements.end(), std::back_inserter(shuffled_columns));
 
-          std::random_shuffle(shuffled_rows.begin(), shuffled_rows.end());
-          std::random_shuffle(shuffled_columns.begin(), shuffled_columns.end());
+          std::shuffle(shuffled_rows.begin(), shuffled_rows.end(), _random_engine);
+          std::shuffle(shuffled_columns.begin(), shuffled_columns.end(), _random_engine);
 
           std::vector <matroid_element_set> bundles;
 
@@ -383,6 +564,9 @@ namespace tu
           }
         }
       }
+
+    protected:
+      std::mt19937 _random_engine;
     };
 
   }
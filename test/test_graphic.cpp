@@ -72,9 +72,51 @@ void testBinaryNongraphicMatrix(
   bool isGraphic;
   TU_CHRMAT* transpose = NULL;
   ASSERT_TU_CALL( TUchrmatTranspose(tu, matrix, &transpose) );
+  TU_SUBMAT* submatrix = NULL;
+  ASSERT_TU_CALL( TUtestBinaryGraphic(tu, transpose, &isGraphic, NULL, NULL, NULL, &submatrix) );
+  ASSERT_FALSE( isGraphic );
+  ASSERT_TRUE( submatrix );
+  ASSERT_TU_CALL( TUchrmatFree(tu, &transpose) );
+
+  /* The submatrix must be nongraphic, but removing any row or column must yield a graphic matrix. */
+  TU_CHRMAT* violator = NULL;
+  ASSERT_TU_CALL( TUchrmatFilterSubmat(tu, matrix, submatrix, &violator) );
+  ASSERT_TU_CALL( TUchrmatTranspose(tu, violator, &transpose) );
   ASSERT_TU_CALL( TUtestBinaryGraphic(tu, transpose, &isGraphic, NULL, NULL, NULL, NULL) );
   ASSERT_FALSE( isGraphic );
   ASSERT_TU_CALL( TUchrmatFree(tu, &transpose) );
+
+  for (int i = 0; i < submatrix->numRows + submatrix->numColumns; ++i)
+  {
+    TU_SUBMAT* smaller = NULL;
+    bool removeRow = i < submatrix->numRows;
+    ASSERT_TU_CALL( TUsubmatCreate(tu, &smaller, submatrix->numRows - (removeRow ? 1 : 0),
+      submatrix->numColumns - (removeRow ? 0 : 1)) );
+    smaller->numRows = 0;
+    for (int r = 0; r < submatrix->numRows; ++r)
+    {
+      if (!removeRow || r != i)
+        smaller->rows[smaller->numRows++] = r;
+    }
+    smaller->numColumns = 0;
+    for (int c = 0; c < submatrix->numColumns; ++c)
+    {
+      if (removeRow || c != i - submatrix->numRows)
+        smaller->columns[smaller->numColumns++] = c;
+    }
+
+    TU_CHRMAT* smallerMatrix = NULL;
+    ASSERT_TU_CALL( TUchrmatFilterSubmat(tu, violator, smaller, &smallerMatrix) );
+    ASSERT_TU_CALL( TUchrmatTranspose(tu, smallerMatrix, &transpose) );
+    ASSERT_TU_CALL( TUtestBinaryGraphic(tu, transpose, &isGraphic, NULL, NULL, NULL, NULL) );
+    ASSERT_TRUE( isGraphic );
+    ASSERT_TU_CALL( TUchrmatFree(tu, &transpose) );
+    ASSERT_TU_CALL( TUchrmatFree(tu, &smallerMatrix) );
+    ASSERT_TU_CALL( TUsubmatFree(tu, &smaller) );
+  }
+
+  ASSERT_TU_CALL( TUchrmatFree(tu, &violator) );
+  ASSERT_TU_CALL( TUsubmatFree(tu, &submatrix) );
 }
 
 void testBinaryMatrix(
@@ -241,6 +283,24 @@ TEST(Graphic, TypingRootRigidOnePathTwoSingleChildren)
   ASSERT_TU_CALL( TUfreeEnvironment(&tu) );
 }
 
+TEST(Graphic, TypingRootRigidOnePathTwoSingleChildrenCommonEnd)
+{
+  /* Both child markers are incident to the same path end node. */
+  TU* tu = NULL;
+  ASSERT_TU_CALL( TUcreateEnvironment(&tu) );
+  TU_CHRMAT* matrix = NULL;
+  ASSERT_TU_CALL( stringToCharMatrix(tu, &matrix, "5 4 "
+    "1 1 0 0 "
+    "1 1 1 1 "
+    "1 0 1 1 "
+    "1 0 1 0 "
+    "0 1 0 1 "
+  ) );
+  testBinaryNongraphicMatrix(tu, matrix);
+  ASSERT_TU_CALL( TUchrmatFree(tu, &matrix) );
+  ASSERT_TU_CALL( TUfreeEnvironment(&tu) );
+}
+
 
 TEST(Graphic, TypingRootRigidOnePathDoubleChild)
 {
@@ -1104,3 +1164,66 @@ TEST(Graphic, Ternary)
   ASSERT_TU_CALL( TUchrmatFree(tu, &matrix) );
   ASSERT_TU_CALL( TUfreeEnvironment(&tu) );
 }
+
+TEST(Graphic, Incremental)
+{
+  TU* tu = NULL;
+  ASSERT_TU_CALL( TUcreateEnvironment(&tu) );
+
+  /* Columns of the Fano matroid; the last one destroys graphicness. Row 3 stays empty. */
+  int columns[4][3] = { {0, 1, -1}, {0, 2, -1}, {1, 2, -1}, {0, 1, 2} };
+  int lengths[4] = { 2, 2, 2, 3 };
+
+  TU_GRAPHIC_DEC* gdec = NULL;
+  ASSERT_TU_CALL( TUgraphicDecCreate(tu, &gdec, 4) );
+  ASSERT_EQ( TUgraphicDecNumRows(gdec), 4 );
+
+  bool isGraphic;
+  for (int c = 0; c < 3; ++c)
+  {
+    ASSERT_TU_CALL( TUgraphicDecAddColumn(tu, gdec, columns[c], lengths[c], false, &isGraphic) );
+    ASSERT_TRUE( isGraphic );
+    ASSERT_EQ( TUgraphicDecNumColumns(gdec), c );
+    ASSERT_TU_CALL( TUgraphicDecAddColumn(tu, gdec, columns[c], lengths[c], true, &isGraphic) );
+    ASSERT_TRUE( isGraphic );
+    ASSERT_EQ( TUgraphicDecNumColumns(gdec), c + 1 );
+  }
+
+  ASSERT_TU_CALL( TUgraphicDecAddColumn(tu, gdec, columns[3], lengths[3], true, &isGraphic) );
+  ASSERT_FALSE( isGraphic );
+  ASSERT_EQ( TUgraphicDecNumColumns(gdec), 3 );
+
+  TU_GRAPH* graph = NULL;
+  TU_GRAPH_EDGE* basis = NULL;
+  TU_GRAPH_EDGE* cobasis = NULL;
+  ASSERT_TU_CALL( TUgraphicDecGraph(tu, gdec, &graph, &basis, &cobasis) );
+
+  TU_CHRMAT* result = NULL;
+  bool isCorrectBasis;
+  ASSERT_TU_CALL( TUcomputeGraphBinaryRepresentationMatrix(tu, graph, &result, NULL, 4, basis, 3, cobasis,
+    &isCorrectBasis) );
+  ASSERT_TRUE( isCorrectBasis );
+
+  TU_CHRMAT* check = NULL;
+  ASSERT_TU_CALL( stringToCharMatrix(tu, &check, "4 3 "
+    "1 1 0 "
+    "1 0 1 "
+    "0 1 1 "
+    "0 0 0 "
+  ) );
+  ASSERT_TRUE( TUchrmatCheckEqual(check, result) );
+
+  /* The decomposition remains usable after querying the graph. */
+  int lastColumn[2] = { 2, 3 };
+  ASSERT_TU_CALL( TUgraphicDecAddColumn(tu, gdec, lastColumn, 2, true, &isGraphic) );
+  ASSERT_TRUE( isGraphic );
+  ASSERT_EQ( TUgraphicDecNumColumns(gdec), 4 );
+
+  ASSERT_TU_CALL( TUchrmatFree(tu, &check) );
+  ASSERT_TU_CALL( TUchrmatFree(tu, &result) );
+  ASSERT_TU_CALL( TUgraphFree(tu, &graph) );
+  ASSERT_TU_CALL( TUfreeBlockArray(tu, &basis) );
+  ASSERT_TU_CALL( TUfreeBlockArray(tu, &cobasis) );
+  ASSERT_TU_CALL( TUgraphicDecFree(tu, &gdec) );
+  ASSERT_TU_CALL( TUfreeEnvironment(&tu) );
+}
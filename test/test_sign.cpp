@@ -63,3 +63,36 @@ TEST(Sign, Change)
 
   TUfreeEnvironment(&tu);
 }
+
+TEST(Sign, LongCycle)
+{
+  TU* tu = NULL;
+  ASSERT_TU_CALL( TUcreateEnvironment(&tu) );
+
+  /* Cycle of length 402 whose only chordless cycle is the whole matrix. */
+  const int n = 201;
+  TU_CHRMAT* matrix = NULL;
+  ASSERT_TU_CALL( TUchrmatCreate(tu, &matrix, n, n, 2*n) );
+  for (int row = 0; row < n; ++row)
+  {
+    int first = row + 1 < n ? row : 0;
+    int second = row + 1 < n ? row + 1 : row;
+    matrix->rowStarts[row] = 2*row;
+    matrix->entryColumns[2*row] = first;
+    matrix->entryValues[2*row] = 1;
+    matrix->entryColumns[2*row + 1] = second;
+    matrix->entryValues[2*row + 1] = 1;
+  }
+
+  bool alreadySigned;
+  ASSERT_TU_CALL( TUtestSignChr(tu, matrix, &alreadySigned, NULL) );
+  ASSERT_FALSE(alreadySigned);
+  ASSERT_TU_CALL( TUcorrectSignChr(tu, matrix, &alreadySigned, NULL) );
+  ASSERT_FALSE(alreadySigned);
+  ASSERT_TU_CALL( TUtestSignChr(tu, matrix, &alreadySigned, NULL) );
+  ASSERT_TRUE(alreadySigned);
+
+  ASSERT_TU_CALL( TUchrmatFree(tu, &matrix) );
+
+  TUfreeEnvironment(&tu);
+}
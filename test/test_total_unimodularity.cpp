@@ -0,0 +1,665 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include <tu/total_unimodularity.hpp>
+#include <tu/matroid_decomposition.hpp>
+
+/**
+ * \brief Sparse interval matrix whose row \p i has ones in the columns \p i, ..., \p i + \p length - 1.
+ *
+ * If \p extraBlock is \c true, two rows forming the non-TU block [1 1; 1 -1] in two new columns are appended.
+ */
+
+static void createIntervalMatrix(
+  std::size_t numRows,        /**< Number of interval rows. */
+  std::size_t length,         /**< Number of nonzeros per interval row. */
+  bool extraBlock,            /**< Whether to append the non-TU block. */
+  tu::SparseMatrix<char>& matrix, /**< Returns the sparse matrix. */
+  tu::integer_matrix& dense   /**< Returns the same matrix in dense form. */
+)
+{
+  std::size_t numColumns = numRows + length - 1 + (extraBlock ? 2 : 0);
+  std::size_t totalRows = numRows + (extraBlock ? 2 : 0);
+  std::vector<std::size_t> first;
+  std::vector<std::size_t> columns;
+  std::vector<char> values;
+  dense = tu::integer_matrix(totalRows, numColumns);
+  for (std::size_t row = 0; row < totalRows; ++row)
+  {
+    for (std::size_t column = 0; column < numColumns; ++column)
+      dense(row, column) = 0;
+  }
+
+  for (std::size_t row = 0; row < numRows; ++row)
+  {
+    first.push_back(columns.size());
+    for (std::size_t column = row; column < row + length; ++column)
+    {
+      columns.push_back(column);
+      values.push_back(1);
+      dense(row, column) = 1;
+    }
+  }
+  if (extraBlock)
+  {
+    for (std::size_t i = 0; i < 2; ++i)
+    {
+      first.push_back(columns.size());
+      for (std::size_t j = 0; j < 2; ++j)
+      {
+        char value = (i == 1 && j == 1) ? -1 : 1;
+        columns.push_back(numColumns - 2 + j);
+        values.push_back(value);
+        dense(numRows + i, numColumns - 2 + j) = value;
+      }
+    }
+  }
+
+  matrix.set(true, totalRows, numColumns, columns.size(), &first[0], NULL, &columns[0], &values[0], false, true);
+}
+
+TEST(TotalUnimodularity, SparseLongRows)
+{
+  /* More than 127 nonzeros per row and column indices beyond the range of char. */
+  tu::SparseMatrix<char> matrix;
+  tu::integer_matrix dense;
+  createIntervalMatrix(160, 150, false, matrix, dense);
+  ASSERT_GT(matrix.numNonzeros(), 127);
+
+  ASSERT_TRUE(tu::is_totally_unimodular(matrix));
+  tu::submatrix_indices violator;
+  ASSERT_TRUE(tu::is_totally_unimodular(matrix, violator));
+}
+
+TEST(TotalUnimodularity, SparseViolator)
+{
+  tu::SparseMatrix<char> matrix;
+  tu::integer_matrix dense;
+  createIntervalMatrix(160, 150, true, matrix, dense);
+
+  ASSERT_FALSE(tu::is_totally_unimodular(matrix));
+  tu::submatrix_indices violator;
+  ASSERT_FALSE(tu::is_totally_unimodular(matrix, violator));
+  ASSERT_EQ(violator.rows.size(), violator.columns.size());
+  for (std::size_t r = 0; r < violator.rows.size(); ++r)
+    ASSERT_GE(violator.rows[r], 160);
+  for (std::size_t c = 0; c < violator.columns.size(); ++c)
+    ASSERT_GE(violator.columns[c], dense.size2() - 2);
+  long long determinant = tu::submatrix_determinant(dense, violator);
+  ASSERT_TRUE(determinant < -1 || determinant > 1);
+}
+
+/**
+ * \brief Returns the indices of the square submatrix with the given rows and columns.
+ */
+
+static tu::submatrix_indices createSubmatrix(
+  const std::vector<std::size_t>& rows,   /**< Row indices. */
+  const std::vector<std::size_t>& columns /**< Column indices. */
+)
+{
+  tu::submatrix_indices::vector_type rowVector(rows.size());
+  for (std::size_t i = 0; i < rows.size(); ++i)
+    rowVector[i] = rows[i];
+  tu::submatrix_indices::vector_type columnVector(columns.size());
+  for (std::size_t i = 0; i < columns.size(); ++i)
+    columnVector[i] = columns[i];
+
+  tu::submatrix_indices submatrix;
+  submatrix.rows = tu::submatrix_indices::indirect_array_type(rows.size(), rowVector);
+  submatrix.columns = tu::submatrix_indices::indirect_array_type(columns.size(), columnVector);
+  return submatrix;
+}
+
+TEST(TotalUnimodularity, DeterminantSingular)
+{
+  tu::integer_matrix matrix(3, 3);
+  const long long entries[3][3] = { { 1, 2, 3 }, { 2, 4, 6 }, { 0, 0, 5 } };
+  for (std::size_t row = 0; row < 3; ++row)
+  {
+    for (std::size_t column = 0; column < 3; ++column)
+      matrix(row, column) = entries[row][column];
+  }
+
+  /* The first two rows are dependent, and the second column has no pivot after the first step. */
+  ASSERT_EQ(tu::submatrix_determinant(matrix, createSubmatrix({ 0, 1, 2 }, { 0, 1, 2 })), 0);
+  ASSERT_EQ(tu::submatrix_determinant(matrix, createSubmatrix({ 0, 1 }, { 0, 2 })), 0);
+  ASSERT_EQ(tu::submatrix_determinant(matrix, createSubmatrix({ 2 }, { 1 })), 0);
+  ASSERT_EQ(tu::submatrix_determinant(matrix, createSubmatrix({ 1, 2 }, { 1, 2 })), 20);
+}
+
+TEST(TotalUnimodularity, DeterminantPivotSign)
+{
+  tu::integer_matrix matrix(4, 4);
+  for (std::size_t row = 0; row < 4; ++row)
+  {
+    for (std::size_t column = 0; column < 4; ++column)
+      matrix(row, column) = 0;
+  }
+  /* Both diagonal blocks have their nonzeros off the diagonal, so each needs a row swap. */
+  matrix(0, 1) = 1;
+  matrix(1, 0) = 1;
+  matrix(2, 3) = 2;
+  matrix(3, 2) = 3;
+
+  ASSERT_EQ(tu::submatrix_determinant(matrix, createSubmatrix({ 0, 1 }, { 0, 1 })), -1);
+  ASSERT_EQ(tu::submatrix_determinant(matrix, createSubmatrix({ 1, 0 }, { 0, 1 })), 1);
+  ASSERT_EQ(tu::submatrix_determinant(matrix, createSubmatrix({ 0, 1, 2, 3 }, { 0, 1, 2, 3 })), 6);
+  ASSERT_EQ(tu::submatrix_determinant(matrix, createSubmatrix({ 0, 2, 3 }, { 1, 2, 3 })), -6);
+
+  std::vector<tu::submatrix_indices> submatrices;
+  submatrices.push_back(createSubmatrix({ 0, 1 }, { 0, 1 }));
+  submatrices.push_back(createSubmatrix({ 2, 3 }, { 2, 3 }));
+  submatrices.push_back(createSubmatrix({ 2, 3 }, { 3, 2 }));
+  std::vector<long long> determinants;
+  tu::submatrix_determinants(matrix, submatrices, determinants);
+  ASSERT_EQ(determinants.size(), 3);
+  ASSERT_EQ(determinants[0], -1);
+  ASSERT_EQ(determinants[1], -6);
+  ASSERT_EQ(determinants[2], 6);
+}
+
+TEST(TotalUnimodularity, DeterminantOverflow)
+{
+  /* The products of the elimination overflow long long, but the determinant 2^41 - 1 does not. */
+  const long long large = 1LL << 40;
+  tu::integer_matrix matrix(2, 2);
+  matrix(0, 0) = large;
+  matrix(0, 1) = large - 1;
+  matrix(1, 0) = large - 1;
+  matrix(1, 1) = large;
+  tu::submatrix_indices all = createSubmatrix({ 0, 1 }, { 0, 1 });
+#ifdef __SIZEOF_INT128__
+  ASSERT_EQ(tu::submatrix_determinant(matrix, all), 2 * large - 1);
+#else
+  ASSERT_THROW(tu::submatrix_determinant(matrix, all), std::overflow_error);
+#endif
+
+  /* The determinant 2^125 itself exceeds long long. */
+  const long long huge = 1LL << 62;
+  matrix(0, 0) = huge;
+  matrix(0, 1) = -huge;
+  matrix(1, 0) = huge;
+  matrix(1, 1) = huge;
+  ASSERT_THROW(tu::submatrix_determinant(matrix, all), std::overflow_error);
+  std::vector<tu::submatrix_indices> submatrices(1, all);
+  std::vector<long long> determinants;
+  ASSERT_THROW(tu::submatrix_determinants(matrix, submatrices, determinants), std::overflow_error);
+}
+
+TEST(TotalUnimodularity, NumThreads)
+{
+  /* Verdicts and violators must not depend on the number of threads. */
+  std::mt19937 generator(12);
+  std::uniform_int_distribution<int> entry(-3, 3);
+  for (int instance = 0; instance < 40; ++instance)
+  {
+    tu::integer_matrix matrix(10, 11);
+    for (std::size_t row = 0; row < matrix.size1(); ++row)
+    {
+      for (std::size_t column = 0; column < matrix.size2(); ++column)
+      {
+        int value = entry(generator);
+        matrix(row, column) = value == 1 ? 1 : (value == -1 ? -1 : 0);
+      }
+    }
+
+    tu::submatrix_indices sequentialViolator, parallelViolator;
+    tu::set_num_threads(1);
+    bool sequential = tu::is_totally_unimodular(matrix, sequentialViolator);
+    tu::set_num_threads(4);
+    bool parallel = tu::is_totally_unimodular(matrix, parallelViolator);
+    tu::set_num_threads(1);
+
+    ASSERT_EQ(sequential, parallel);
+    if (!sequential)
+    {
+      long long determinant = tu::submatrix_determinant(matrix, parallelViolator);
+      ASSERT_TRUE(determinant < -1 || determinant > 1);
+    }
+  }
+}
+
+/**
+ * \brief Advances \p subset to the lexicographically next subset of {0, ..., \p size - 1} of the same cardinality.
+ *
+ * \returns \c false if \p subset was the last one.
+ */
+
+static bool nextSubset(
+  std::vector<std::size_t>& subset, /**< Increasing vector of indices. */
+  std::size_t size                  /**< Size of the ground set. */
+)
+{
+  std::size_t i = subset.size();
+  while (i > 0 && subset[i - 1] == size - subset.size() + i - 1)
+    --i;
+  if (i == 0)
+    return false;
+  ++subset[i - 1];
+  for (std::size_t j = i; j < subset.size(); ++j)
+    subset[j] = subset[j - 1] + 1;
+  return true;
+}
+
+/**
+ * \brief Finds the smallest square submatrix with a determinant other than -1, 0 and +1, whose rows and then columns
+ * are lexicographically minimal, by trying all of them.
+ *
+ * \returns \c true if and only if there is no such submatrix.
+ */
+
+static bool bruteForceTotalUnimodularity(
+  const tu::integer_matrix& matrix, /**< Matrix to be tested. */
+  std::vector<std::size_t>& rows,   /**< Returns the rows of the violator. */
+  std::vector<std::size_t>& columns /**< Returns the columns of the violator. */
+)
+{
+  for (std::size_t size = 1; size <= std::min(matrix.size1(), matrix.size2()); ++size)
+  {
+    rows.resize(size);
+    for (std::size_t i = 0; i < size; ++i)
+      rows[i] = i;
+    do
+    {
+      columns.resize(size);
+      for (std::size_t i = 0; i < size; ++i)
+        columns[i] = i;
+      do
+      {
+        long long determinant = tu::submatrix_determinant(matrix, createSubmatrix(rows, columns));
+        if (determinant < -1 || determinant > 1)
+          return false;
+      }
+      while (nextSubset(columns, matrix.size2()));
+    }
+    while (nextSubset(rows, matrix.size1()));
+  }
+  return true;
+}
+
+TEST(TotalUnimodularity, DeterminantCriterion)
+{
+  /* Random ternary matrices of varying density. */
+  std::mt19937 generator(7);
+  std::size_t numTU = 0;
+  for (int instance = 0; instance < 300; ++instance)
+  {
+    tu::integer_matrix matrix(4 + instance % 3, 5 + instance % 2);
+    const unsigned int density = 2 + instance % 5;
+    for (std::size_t row = 0; row < matrix.size1(); ++row)
+    {
+      for (std::size_t column = 0; column < matrix.size2(); ++column)
+      {
+        unsigned int value = generator() % 10;
+        matrix(row, column) = value >= density ? 0 : (value % 2 ? -1 : 1);
+      }
+    }
+
+    std::vector<std::size_t> rows, columns;
+    bool expected = bruteForceTotalUnimodularity(matrix, rows, columns);
+    if (expected)
+      ++numTU;
+
+    tu::submatrix_indices violator;
+    ASSERT_EQ(tu::is_totally_unimodular(matrix, violator), expected);
+    if (!expected)
+    {
+      ASSERT_EQ(violator.rows.size(), violator.columns.size());
+      long long determinant = tu::submatrix_determinant(matrix, violator);
+      ASSERT_TRUE(determinant < -1 || determinant > 1);
+    }
+
+    for (std::size_t numThreads = 1; numThreads <= 4; numThreads += 3)
+    {
+      tu::set_num_threads(numThreads);
+      tu::submatrix_indices smallest;
+      bool result = tu::determinant_is_totally_unimodular(matrix, smallest);
+      tu::set_num_threads(1);
+      ASSERT_EQ(result, expected);
+      ASSERT_EQ(tu::determinant_is_totally_unimodular(matrix), expected);
+      if (!expected)
+      {
+        ASSERT_EQ(smallest.rows.size(), rows.size());
+        ASSERT_EQ(smallest.columns.size(), columns.size());
+        for (std::size_t i = 0; i < rows.size(); ++i)
+        {
+          ASSERT_EQ(smallest.rows[i], rows[i]);
+          ASSERT_EQ(smallest.columns[i], columns[i]);
+        }
+      }
+    }
+  }
+  ASSERT_GT(numTU, 0);
+  ASSERT_LT(numTU, 300);
+}
+
+/**
+ * \brief Returns the network matrix of K_5 with respect to a spanning path, which is graphic but not cographic.
+ */
+
+static tu::integer_matrix createK5Matrix()
+{
+  tu::integer_matrix matrix(4, 6);
+  for (std::size_t row = 0; row < 4; ++row)
+  {
+    for (std::size_t column = 0; column < 6; ++column)
+      matrix(row, column) = 0;
+  }
+  std::size_t column = 0;
+  for (std::size_t first = 0; first < 4; ++first)
+  {
+    for (std::size_t second = first + 1; second < 4; ++second)
+    {
+      matrix(first, column) = -1;
+      matrix(second, column) = 1;
+      ++column;
+    }
+  }
+  return matrix;
+}
+
+/**
+ * \brief Returns a signed representation matrix of R10.
+ */
+
+static tu::integer_matrix createR10Matrix()
+{
+  const long long entries[5][5] = { { 1, 1, 0, 0, 1 }, { 1, 1, 1, 0, 0 }, { 0, 1, 1, -1, 0 }, { 0, 0, 1, -1, -1 },
+    { 1, 0, 0, 1, 1 } };
+  tu::integer_matrix matrix(5, 5);
+  for (std::size_t row = 0; row < 5; ++row)
+  {
+    for (std::size_t column = 0; column < 5; ++column)
+      matrix(row, column) = entries[row][column];
+  }
+  return matrix;
+}
+
+/**
+ * \brief Returns the 2-sum [A, a * b^T; 0, B] of [A, a] and [b^T; B], whose marker is the last column of \p first
+ * and the first row of \p second.
+ */
+
+static tu::integer_matrix createTwoSum(
+  const tu::integer_matrix& first,  /**< Matrix [A, a]. */
+  const tu::integer_matrix& second  /**< Matrix [b^T; B]. */
+)
+{
+  const std::size_t firstHeight = first.size1();
+  const std::size_t firstWidth = first.size2() - 1;
+  tu::integer_matrix matrix(firstHeight + second.size1() - 1, firstWidth + second.size2());
+  for (std::size_t row = 0; row < matrix.size1(); ++row)
+  {
+    for (std::size_t column = 0; column < matrix.size2(); ++column)
+    {
+      if (row < firstHeight)
+      {
+        matrix(row, column) = column < firstWidth ? first(row, column)
+          : first(row, firstWidth) * second(0, column - firstWidth);
+      }
+      else
+        matrix(row, column) = column < firstWidth ? 0 : second(row - firstHeight + 1, column - firstWidth);
+    }
+  }
+  return matrix;
+}
+
+/**
+ * \brief Checks that the children of each separator partition its elements up to the shared marker elements and
+ * collects the leaves.
+ */
+
+static void checkDecomposition(
+  const tu::decomposed_matroid* node,               /**< Node of the decomposition tree. */
+  std::vector<const tu::decomposed_matroid_leaf*>& leaves /**< Collects the leaves. */
+)
+{
+  ASSERT_TRUE(node != NULL);
+  if (node->is_leaf())
+  {
+    leaves.push_back(static_cast<const tu::decomposed_matroid_leaf*>(node));
+    return;
+  }
+
+  const tu::decomposed_matroid_separator* separator = static_cast<const tu::decomposed_matroid_separator*>(node);
+  const tu::matroid_element_set& first = separator->first()->elements();
+  const tu::matroid_element_set& second = separator->second()->elements();
+  tu::matroid_element_set united, shared;
+  std::set_union(first.begin(), first.end(), second.begin(), second.end(), std::inserter(united, united.end()));
+  std::set_intersection(first.begin(), first.end(), second.begin(), second.end(), std::inserter(shared, shared.end()));
+  ASSERT_EQ(united, node->elements());
+
+  /* A k-sum shares a row and column per rank of the off-diagonal blocks. */
+  const std::size_t expectedShared[4] = { 0, 0, 2, 6 };
+  ASSERT_GE(separator->separation_type(), 1);
+  ASSERT_LE(separator->separation_type(), 3);
+  ASSERT_EQ(shared.size(), expectedShared[separator->separation_type()]);
+
+  checkDecomposition(separator->first(), leaves);
+  checkDecomposition(separator->second(), leaves);
+}
+
+/**
+ * \brief Tests \p matrix for total unimodularity, checks the decomposition tree and returns its root and leaves.
+ */
+
+static void decompose(
+  const tu::integer_matrix& matrix,                 /**< Matrix to be tested. */
+  tu::decomposed_matroid*& decomposition,           /**< Returns the root of the decomposition tree. */
+  std::vector<const tu::decomposed_matroid_leaf*>& leaves /**< Returns the leaves. */
+)
+{
+  decomposition = NULL;
+  ASSERT_TRUE(tu::is_totally_unimodular(matrix, decomposition));
+  ASSERT_TRUE(decomposition != NULL);
+  ASSERT_TRUE(decomposition->is_regular());
+
+  tu::matroid_element_set elements;
+  for (std::size_t row = 0; row < matrix.size1(); ++row)
+    elements.insert(-1 - int(row));
+  for (std::size_t column = 0; column < matrix.size2(); ++column)
+    elements.insert(1 + int(column));
+  ASSERT_EQ(decomposition->elements(), elements);
+
+  checkDecomposition(decomposition, leaves);
+}
+
+TEST(TotalUnimodularity, DecomposeGraphicCographicTwoSum)
+{
+  tu::integer_matrix k5 = createK5Matrix();
+  tu::integer_matrix cographicK5(k5.size2(), k5.size1());
+  for (std::size_t row = 0; row < k5.size2(); ++row)
+  {
+    for (std::size_t column = 0; column < k5.size1(); ++column)
+      cographicK5(row, column) = k5(column, row);
+  }
+  tu::integer_matrix matrix = createTwoSum(k5, cographicK5);
+
+  tu::decomposed_matroid* decomposition = NULL;
+  std::vector<const tu::decomposed_matroid_leaf*> leaves;
+  decompose(matrix, decomposition, leaves);
+  ASSERT_FALSE(decomposition->is_leaf());
+  ASSERT_EQ(static_cast<tu::decomposed_matroid_separator*>(decomposition)->separation_type(),
+    tu::decomposed_matroid_separator::TWO_SEPARATION);
+  ASSERT_EQ(leaves.size(), 2);
+  ASSERT_NE(leaves[0]->is_graphic(), leaves[1]->is_graphic());
+  ASSERT_NE(leaves[0]->is_cographic(), leaves[1]->is_cographic());
+  for (std::size_t i = 0; i < 2; ++i)
+  {
+    ASSERT_NE(leaves[i]->is_graphic(), leaves[i]->is_cographic());
+    ASSERT_EQ(leaves[i]->elements().size(), 10);
+  }
+  delete decomposition;
+}
+
+TEST(TotalUnimodularity, DecomposeR10TwoSum)
+{
+  tu::integer_matrix matrix = createTwoSum(createK5Matrix(), createR10Matrix());
+
+  tu::decomposed_matroid* decomposition = NULL;
+  std::vector<const tu::decomposed_matroid_leaf*> leaves;
+  decompose(matrix, decomposition, leaves);
+  ASSERT_FALSE(decomposition->is_leaf());
+  ASSERT_EQ(static_cast<tu::decomposed_matroid_separator*>(decomposition)->separation_type(),
+    tu::decomposed_matroid_separator::TWO_SEPARATION);
+  ASSERT_EQ(leaves.size(), 2);
+  std::size_t numR10 = 0;
+  for (std::size_t i = 0; i < 2; ++i)
+  {
+    if (leaves[i]->is_R10())
+    {
+      ++numR10;
+      ASSERT_FALSE(leaves[i]->is_graphic());
+      ASSERT_FALSE(leaves[i]->is_cographic());
+    }
+    else
+      ASSERT_TRUE(leaves[i]->is_graphic());
+    ASSERT_EQ(leaves[i]->elements().size(), 10);
+  }
+  ASSERT_EQ(numR10, 1);
+  delete decomposition;
+}
+
+TEST(TotalUnimodularity, DecomposeThreeSum)
+{
+  /* R12 is the 3-sum of a graphic and a cographic matroid. R10 cannot take part in a 3-sum of a regular matroid. */
+  const long long entries[6][6] = { { 0, 0, 1, 1, 0, 0 }, { 0, 0, 0, 1, 1, 1 }, { 1, 0, 0, 0, 1, 0 },
+    { 0, 1, 0, 1, 1, 0 }, { 1, 1, 1, 1, 1, 0 }, { 1, 0, 1, 1, 1, 1 } };
+  tu::integer_matrix matrix(6, 6);
+  for (std::size_t row = 0; row < 6; ++row)
+  {
+    for (std::size_t column = 0; column < 6; ++column)
+      matrix(row, column) = entries[row][column];
+  }
+
+  tu::decomposed_matroid* decomposition = NULL;
+  std::vector<const tu::decomposed_matroid_leaf*> leaves;
+  decompose(matrix, decomposition, leaves);
+  ASSERT_FALSE(decomposition->is_leaf());
+  ASSERT_EQ(static_cast<tu::decomposed_matroid_separator*>(decomposition)->separation_type(),
+    tu::decomposed_matroid_separator::THREE_SEPARATION);
+  ASSERT_EQ(leaves.size(), 2);
+  for (std::size_t i = 0; i < 2; ++i)
+  {
+    ASSERT_TRUE(leaves[i]->is_graphic() || leaves[i]->is_cographic());
+    ASSERT_EQ(leaves[i]->elements().size(), 9);
+  }
+  delete decomposition;
+}
+
+/**
+ * \brief Returns the network matrix of a random directed spanning tree and random further arcs.
+ *
+ * Row \p i corresponds to the tree arc from node \p i + 1 to its parent, which is a smaller node, and each column to
+ * an arc whose entries are +1 for the tree arcs on its path in forward and -1 for those in backward direction.
+ */
+
+static tu::integer_matrix createNetworkMatrix(
+  std::mt19937& generator,  /**< Random number generator. */
+  std::size_t numNodes,     /**< Number of nodes of the tree. */
+  std::size_t numArcs       /**< Number of non-tree arcs. */
+)
+{
+  std::vector<std::size_t> parent(numNodes, 0);
+  std::vector<std::size_t> depth(numNodes, 0);
+  for (std::size_t node = 1; node < numNodes; ++node)
+  {
+    parent[node] = generator() % node;
+    depth[node] = depth[parent[node]] + 1;
+  }
+
+  tu::integer_matrix matrix(numNodes - 1, numArcs);
+  for (std::size_t row = 0; row < matrix.size1(); ++row)
+  {
+    for (std::size_t column = 0; column < numArcs; ++column)
+      matrix(row, column) = 0;
+  }
+  for (std::size_t column = 0; column < numArcs; ++column)
+  {
+    std::size_t tail = generator() % numNodes;
+    std::size_t head = generator() % numNodes;
+    while (tail != head)
+    {
+      if (depth[tail] >= depth[head])
+      {
+        matrix(tail - 1, column) = 1;
+        tail = parent[tail];
+      }
+      else
+      {
+        matrix(head - 1, column) = -1;
+        head = parent[head];
+      }
+    }
+  }
+  return matrix;
+}
+
+/**
+ * \brief Checks that all variants of the Ghouila-Houri test agree with \ref tu::is_totally_unimodular on \p matrix.
+ *
+ * \returns Whether \p matrix is totally unimodular.
+ */
+
+static bool checkGhouilaHouri(
+  const tu::integer_matrix& matrix  /**< Matrix to be tested. */
+)
+{
+  const bool expected = tu::is_totally_unimodular(matrix);
+  EXPECT_EQ(tu::ghouila_houri_is_totally_unimodular(matrix), expected);
+  EXPECT_EQ(tu::ghouila_houri_is_totally_unimodular_enum_rows(matrix), expected);
+  EXPECT_EQ(tu::ghouila_houri_is_totally_unimodular_enum_columns(matrix), expected);
+  return expected;
+}
+
+TEST(TotalUnimodularity, GhouilaHouri)
+{
+  /* Network matrices and their transposes are totally unimodular, and perturbed copies usually are not. */
+  std::mt19937 generator(3);
+  std::size_t numPerturbedTU = 0;
+  for (int instance = 0; instance < 60; ++instance)
+  {
+    tu::integer_matrix matrix = createNetworkMatrix(generator, 5 + instance % 5, 4 + instance % 6);
+    ASSERT_TRUE(checkGhouilaHouri(matrix));
+    ASSERT_TRUE(checkGhouilaHouri(tu::integer_matrix(boost::numeric::ublas::trans(matrix))));
+
+    std::size_t row = generator() % matrix.size1();
+    std::size_t column = generator() % matrix.size2();
+    matrix(row, column) = matrix(row, column) == 0 ? 1 : -matrix(row, column);
+    if (checkGhouilaHouri(matrix))
+      ++numPerturbedTU;
+    checkGhouilaHouri(tu::integer_matrix(boost::numeric::ublas::trans(matrix)));
+  }
+  ASSERT_LT(numPerturbedTU, 60);
+}
+
+TEST(TotalUnimodularity, GhouilaHouriNumThreads)
+{
+  /* Enough rows such that the enumeration is split into tasks by prefixes if threads are available. */
+  std::mt19937 generator(5);
+  for (int instance = 0; instance < 12; ++instance)
+  {
+    tu::integer_matrix matrix = createNetworkMatrix(generator, 12, 8);
+    if (instance % 2)
+    {
+      std::size_t row = generator() % matrix.size1();
+      std::size_t column = generator() % matrix.size2();
+      matrix(row, column) = matrix(row, column) == 0 ? 1 : -matrix(row, column);
+    }
+
+    bool sequential = tu::ghouila_houri_is_totally_unimodular_enum_rows(matrix);
+    tu::set_num_threads(4);
+    bool parallel = tu::ghouila_houri_is_totally_unimodular_enum_rows(matrix);
+    tu::set_num_threads(1);
+    ASSERT_EQ(sequential, parallel);
+    ASSERT_EQ(sequential, tu::is_totally_unimodular(matrix));
+    if (instance % 2 == 0)
+      ASSERT_TRUE(sequential);
+  }
+}
@@ -0,0 +1,274 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common.h"
+#include <tu/sign.h>
+#include <tu/tu.h>
+
+TEST(TU, Graphic)
+{
+  TU* tu = NULL;
+  ASSERT_TU_CALL( TUcreateEnvironment(&tu) );
+
+  TU_CHRMAT* matrix = NULL;
+  ASSERT_TU_CALL( stringToCharMatrix(tu, &matrix, "6 6 "
+    "+1 +1  0  0  0  0 "
+    " 0 -1 +1  0  0  0 "
+    "+1  0 +1  0  0  0 "
+    " 0  0  0 +1 -1  0 "
+    " 0  0  0  0 +1 +1 "
+    " 0  0  0 +1  0 +1 "
+  ) );
+
+  bool isTU;
+  TU_DEC* dec = NULL;
+  TU_SUBMAT* submatrix = NULL;
+  ASSERT_TU_CALL( TUtestTotalUnimodularityChr(tu, matrix, &isTU, &dec, &submatrix) );
+  ASSERT_TRUE(isTU);
+  ASSERT_TRUE(submatrix == NULL);
+  ASSERT_TRUE(dec != NULL);
+  ASSERT_EQ(TUdecIsSum(dec), 1);
+  ASSERT_EQ(dec->numChildren, 2);
+  ASSERT_TRUE(TUdecIsRegular(dec));
+  ASSERT_TRUE(TUdecIsGraphic(dec));
+  for (int c = 0; c < dec->numChildren; ++c)
+  {
+    ASSERT_TRUE(TUdecIsGraphic(dec->children[c]));
+    ASSERT_TRUE(dec->children[c]->graph != NULL);
+    ASSERT_EQ(TUdecNumRows(dec->children[c]), 3);
+  }
+  TUdecFree(tu, &dec);
+
+  ASSERT_TU_CALL( TUtestTotalUnimodularityChr(tu, matrix, &isTU, NULL, NULL) );
+  ASSERT_TRUE(isTU);
+
+  ASSERT_TU_CALL( TUchrmatFree(tu, &matrix) );
+
+  ASSERT_TU_CALL( TUfreeEnvironment(&tu) );
+}
+
+TEST(TU, NonTernary)
+{
+  TU* tu = NULL;
+  ASSERT_TU_CALL( TUcreateEnvironment(&tu) );
+
+  TU_INTMAT* matrix = NULL;
+  ASSERT_TU_CALL( stringToIntMatrix(tu, &matrix, "2 3 "
+    "1 0  1 "
+    "0 1 -2 "
+  ) );
+
+  bool isTU;
+  TU_DEC* dec = NULL;
+  TU_SUBMAT* submatrix = NULL;
+  ASSERT_TU_CALL( TUtestTotalUnimodularityInt(tu, matrix, &isTU, &dec, &submatrix) );
+  ASSERT_FALSE(isTU);
+  ASSERT_TRUE(dec == NULL);
+  ASSERT_TRUE(submatrix != NULL);
+  ASSERT_EQ(submatrix->numRows, 1);
+  ASSERT_EQ(submatrix->rows[0], 1);
+  ASSERT_EQ(submatrix->columns[0], 2);
+  ASSERT_TU_CALL( TUsubmatFree(tu, &submatrix) );
+
+  ASSERT_TU_CALL( TUintmatFree(tu, &matrix) );
+
+  ASSERT_TU_CALL( TUfreeEnvironment(&tu) );
+}
+
+TEST(TU, WrongSign)
+{
+  TU* tu = NULL;
+  ASSERT_TU_CALL( TUcreateEnvironment(&tu) );
+
+  TU_DBLMAT* matrix = NULL;
+  ASSERT_TU_CALL( stringToDoubleMatrix(tu, &matrix, "3 4 "
+    "1  0  0  0 "
+    "0  1 -1  0 "
+    "0 -1 -1  0 "
+  ) );
+
+  bool isTU;
+  TU_DEC* dec = NULL;
+  TU_SUBMAT* submatrix = NULL;
+  ASSERT_TU_CALL( TUtestTotalUnimodularityDbl(tu, matrix, 1.0e-9, &isTU, &dec, &submatrix) );
+  ASSERT_FALSE(isTU);
+  ASSERT_TRUE(dec == NULL);
+  ASSERT_TRUE(submatrix != NULL);
+  ASSERT_EQ(submatrix->numRows, 2);
+  ASSERT_EQ(submatrix->numColumns, 2);
+  ASSERT_EQ(submatrix->rows[0], 1);
+  ASSERT_EQ(submatrix->rows[1], 2);
+  ASSERT_EQ(submatrix->columns[0], 1);
+  ASSERT_EQ(submatrix->columns[1], 2);
+  ASSERT_TU_CALL( TUsubmatFree(tu, &submatrix) );
+
+  ASSERT_TU_CALL( TUdblmatFree(tu, &matrix) );
+
+  ASSERT_TU_CALL( TUfreeEnvironment(&tu) );
+}
+
+TEST(TU, R10)
+{
+  TU* tu = NULL;
+  ASSERT_TU_CALL( TUcreateEnvironment(&tu) );
+
+  TU_CHRMAT* matrix = NULL;
+  ASSERT_TU_CALL( stringToCharMatrix(tu, &matrix, "5 5 "
+    "1 1 0 0 1 "
+    "1 1 1 0 0 "
+    "0 1 1 1 0 "
+    "0 0 1 1 1 "
+    "1 0 0 1 1 "
+  ) );
+  bool alreadySigned;
+  ASSERT_TU_CALL( TUcorrectSignChr(tu, matrix, &alreadySigned, NULL) );
+
+  bool isTU;
+  TU_DEC* dec = NULL;
+  ASSERT_TU_CALL( TUtestTotalUnimodularityChr(tu, matrix, &isTU, &dec, NULL) );
+  ASSERT_TRUE(isTU);
+  ASSERT_TRUE(dec != NULL);
+  ASSERT_TRUE(TUdecIsRegular(dec));
+  ASSERT_FALSE(TUdecIsGraphic(dec));
+  ASSERT_FALSE(TUdecIsCographic(dec));
+  TUdecFree(tu, &dec);
+
+  ASSERT_TU_CALL( TUchrmatFree(tu, &matrix) );
+
+  ASSERT_TU_CALL( TUfreeEnvironment(&tu) );
+}
+
+TEST(TU, Fano)
+{
+  TU* tu = NULL;
+  ASSERT_TU_CALL( TUcreateEnvironment(&tu) );
+
+  TU_CHRMAT* matrix = NULL;
+  ASSERT_TU_CALL( stringToCharMatrix(tu, &matrix, "5 6 "
+    "1 1 0 1 0 0 "
+    "1 0 1 1 0 0 "
+    "0 1 1 1 0 0 "
+    "0 0 0 0 1 1 "
+    "0 0 0 0 0 1 "
+  ) );
+  bool alreadySigned;
+  ASSERT_TU_CALL( TUcorrectSignChr(tu, matrix, &alreadySigned, NULL) );
+
+  bool isTU;
+  TU_SUBMAT* submatrix = NULL;
+  ASSERT_TU_CALL( TUtestTotalUnimodularityChr(tu, matrix, &isTU, NULL, &submatrix) );
+  ASSERT_FALSE(isTU);
+  ASSERT_TRUE(submatrix != NULL);
+  ASSERT_EQ(submatrix->numRows, submatrix->numColumns);
+  for (int r = 0; r < submatrix->numRows; ++r)
+    ASSERT_LT(submatrix->rows[r], 3);
+  for (int c = 0; c < submatrix->numColumns; ++c)
+    ASSERT_LT(submatrix->columns[c], 4);
+  ASSERT_TU_CALL( TUsubmatFree(tu, &submatrix) );
+
+  ASSERT_TU_CALL( TUchrmatFree(tu, &matrix) );
+
+  ASSERT_TU_CALL( TUfreeEnvironment(&tu) );
+}
+
+TEST(TU, ParallelComponents)
+{
+  TU* tu = NULL;
+  ASSERT_TU_CALL( TUcreateEnvironment(&tu) );
+  ASSERT_TU_CALL( TUsetNumThreads(tu, 4) );
+  ASSERT_EQ(TUgetNumThreads(tu), 4);
+
+  /* 40 graphic 3x3 blocks followed by the Fano matroid. */
+  const int numBlocks = 40;
+  const char* graphicBlock[] = { "1 1 0 ", "0 -1 1 ", "1 0 1 " };
+  const char* fanoBlock[] = { "1 1 0 1 ", "1 0 1 1 ", "0 1 1 1 " };
+  const int numRows = 3 * numBlocks + 3;
+  const int numColumns = 3 * numBlocks + 4;
+  std::string string = std::to_string(numRows) + " " + std::to_string(numColumns) + " ";
+  for (int row = 0; row < numRows; ++row)
+  {
+    int block = row / 3;
+    for (int b = 0; b <= numBlocks; ++b)
+    {
+      if (b == block)
+        string += block < numBlocks ? graphicBlock[row % 3] : fanoBlock[row % 3];
+      else
+        string += b < numBlocks ? "0 0 0 " : "0 0 0 0 ";
+    }
+  }
+
+  TU_CHRMAT* matrix = NULL;
+  ASSERT_TU_CALL( stringToCharMatrix(tu, &matrix, string.c_str()) );
+  bool alreadySigned;
+  ASSERT_TU_CALL( TUcorrectSignChr(tu, matrix, &alreadySigned, NULL) );
+
+  bool isTU;
+  TU_SUBMAT* submatrix = NULL;
+  ASSERT_TU_CALL( TUtestTotalUnimodularityChr(tu, matrix, &isTU, NULL, &submatrix) );
+  ASSERT_FALSE(isTU);
+  ASSERT_TRUE(submatrix != NULL);
+  for (int r = 0; r < submatrix->numRows; ++r)
+    ASSERT_GE(submatrix->rows[r], 3 * numBlocks);
+  ASSERT_TU_CALL( TUsubmatFree(tu, &submatrix) );
+
+  TU_DEC* dec = NULL;
+  ASSERT_TU_CALL( TUtestTotalUnimodularityChr(tu, matrix, &isTU, &dec, NULL) );
+  ASSERT_FALSE(isTU);
+  ASSERT_TRUE(dec != NULL);
+  ASSERT_EQ(dec->numChildren, numBlocks + 1);
+  ASSERT_FALSE(TUdecIsRegular(dec));
+  for (int c = 0; c < numBlocks; ++c)
+    ASSERT_TRUE(TUdecIsGraphic(dec->children[c]));
+  ASSERT_FALSE(TUdecIsRegular(dec->children[numBlocks]));
+  TUdecFree(tu, &dec);
+
+  ASSERT_TU_CALL( TUchrmatFree(tu, &matrix) );
+
+  ASSERT_TU_CALL( TUfreeEnvironment(&tu) );
+}
+
+TEST(TU, ThreadEnvironments)
+{
+  TU* tu = NULL;
+  ASSERT_TU_CALL( TUcreateEnvironment(&tu) );
+
+  TU_CHRMAT* matrix = NULL;
+  ASSERT_TU_CALL( stringToCharMatrix(tu, &matrix, "5 5 "
+    "1 1 0 0 1 "
+    "1 1 1 0 0 "
+    "0 1 1 1 0 "
+    "0 0 1 1 1 "
+    "1 0 0 1 1 "
+  ) );
+  bool alreadySigned;
+  ASSERT_TU_CALL( TUcorrectSignChr(tu, matrix, &alreadySigned, NULL) );
+
+  /* Each thread uses its own environment, sharing stack memory with tu. */
+  const int numThreads = 4;
+  TU* children[numThreads];
+  bool isTU[numThreads];
+  std::vector<std::thread> threads;
+  for (int t = 0; t < numThreads; ++t)
+  {
+    children[t] = NULL;
+    ASSERT_TU_CALL( TUcreateThreadEnvironment(tu, &children[t]) );
+    isTU[t] = false;
+    threads.push_back(std::thread([&, t]() {
+      for (int i = 0; i < 20; ++i)
+        TUtestTotalUnimodularityChr(children[t], matrix, &isTU[t], NULL, NULL);
+    }));
+  }
+  for (int t = 0; t < numThreads; ++t)
+  {
+    threads[t].join();
+    ASSERT_TRUE(isTU[t]);
+    ASSERT_TU_CALL( TUfreeEnvironment(&children[t]) );
+  }
+
+  ASSERT_TU_CALL( TUchrmatFree(tu, &matrix) );
+
+  ASSERT_TU_CALL( TUfreeEnvironment(&tu) );
+}